@@ -0,0 +1,85 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+// Replaces the global operator new and delete to count heap allocations,
+// over-aligned ones included. The replacements are ordinary definitions, so
+// include this header from exactly one translation unit of a program. The
+// nothrow and array forms are left to the library, which implements them
+// with these
+
+inline std::atomic<size_t>& allocation_counter() {
+  static std::atomic<size_t> count{0};
+  return count;
+}
+
+// Allocations made through operator new since the program started
+inline size_t allocation_count() {
+  return allocation_counter().load(std::memory_order_relaxed);
+}
+
+// Inlined into their callers, these would let GCC see free() called on a
+// pointer from operator new, or operator delete on one from malloc(), and
+// report -Wmismatched-new-delete. Kept out of line, the pairing it checks
+// is new with delete
+#if defined(__GNUC__) || defined(__clang__)
+#define ALLOC_COUNTER_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define ALLOC_COUNTER_NOINLINE __declspec(noinline)
+#else
+#define ALLOC_COUNTER_NOINLINE
+#endif
+
+ALLOC_COUNTER_NOINLINE void* operator new(size_t size) {
+  allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size > 0 ? size : 1);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new(size_t size,
+                                          std::align_val_t alignment) {
+  allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  size_t align = static_cast<size_t>(alignment);
+  // aligned_alloc wants a multiple of the alignment
+  size_t rounded = (size + align - 1) / align * align;
+#ifdef _WIN32
+  void* p = _aligned_malloc(rounded > 0 ? rounded : align, align);
+#else
+  void* p = aligned_alloc(align, rounded > 0 ? rounded : align);
+#endif
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p) noexcept { free(p); }
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p,
+                                            std::align_val_t) noexcept {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, size_t,
+                                            std::align_val_t) noexcept {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+#undef ALLOC_COUNTER_NOINLINE
+
+#endif
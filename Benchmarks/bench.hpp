@@ -0,0 +1,65 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Minimal timing harness shared by the benchmarks in this directory
+
+// Keep the compiler from discarding a value that is computed but never used
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const T* sink;
+  sink = &value;
+#endif
+}
+
+// Run body once per repetition and return the fastest run in nanoseconds
+template <typename F>
+double time_ns(F&& body, int repetitions = 5) {
+  double best = 0;
+  for (int r = 0; r < repetitions; r++) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    double elapsed =
+        std::chrono::duration<double, std::nano>(stop - start).count();
+    if (r == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return best;
+}
+
+inline void report(const char* name, size_t n, double ns, size_t ops) {
+  printf("%-44s n=%-10zu %12.3f ms %10.3f ns/op\n", name, n, ns / 1e6,
+         ops > 0 ? ns / ops : 0.0);
+}
+
+// Peak resident set size of the process in KiB, or 0 where unknown
+inline size_t peak_rss_kib() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss) / 1024;  // Bytes on macOS
+#else
+  return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#else
+  return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,73 @@
+// BPlusTree against BinarySearchTree and AVLTree on random keys. Lookups on
+// the larger sizes are dominated by cache misses: the binary trees take one
+// per level, the B+-tree one or two per node of many keys. The scalar row
+// forces the binary-search fallback by wrapping the key in a struct
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../Trees/b-plus-tree.hpp"
+#include "../Trees/binary-search-tree.hpp"
+#include "bench.hpp"
+
+// Not arithmetic, so BPlusTree searches its nodes with std::lower_bound
+struct Key {
+  int value;
+  Key(int v = 0) : value{v} {}
+  bool operator<(const Key& rhs) const { return value < rhs.value; }
+  bool operator==(const Key& rhs) const { return value == rhs.value; }
+  bool operator>(const Key& rhs) const { return rhs.value < value; }
+};
+
+template <typename Tree, typename K>
+void run(const char* tree_name, const std::vector<K>& keys,
+         const std::vector<K>& probes) {
+  size_t n = keys.size();
+  char label[64];
+  Tree tree;
+
+  snprintf(label, sizeof label, "%s insert", tree_name);
+  report(label, n, time_ns([&] {
+           for (const K& key : keys) tree.insert(key);
+         }, 1),
+         n);
+
+  snprintf(label, sizeof label, "%s contains", tree_name);
+  report(label, n, time_ns([&] {
+           size_t found = 0;
+           for (const K& key : probes) found += tree.contains(key);
+           do_not_optimize(found);
+         }),
+         probes.size());
+
+  snprintf(label, sizeof label, "%s remove", tree_name);
+  report(label, n, time_ns([&] {
+           for (const K& key : keys) tree.remove(key);
+         }, 1),
+         n);
+}
+
+int main() {
+  std::mt19937 rng(42);
+
+  for (size_t n = 1000; n <= 10000000; n *= 10) {
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) keys[i] = static_cast<int>(i * 2);
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    // Half of the probes miss
+    std::vector<int> probes(1000000);
+    for (int& probe : probes) probe = static_cast<int>(rng() % (2 * n));
+    std::vector<Key> wrappedKeys(keys.begin(), keys.end());
+    std::vector<Key> wrappedProbes(probes.begin(), probes.end());
+
+    run<BinarySearchTree<int>>("BST", keys, probes);
+    run<AVLTree<int>>("AVLTree", keys, probes);
+    run<BPlusTree<int, 256>>("BPlusTree<int, 256>", keys, probes);
+    run<BPlusTree<int>>("BPlusTree<int, 512>", keys, probes);
+    run<BPlusTree<Key>>("BPlusTree<Key, 512> (binary search)", wrappedKeys,
+                        wrappedProbes);
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+// BinarySearchTree with and without AVL balancing on sorted, reverse-sorted
+// and random keys. The unbalanced tree degenerates into a chain on sorted
+// input, where every operation costs O(n), so it runs those on the smaller
+// sizes only; one more row builds a chain 100000 nodes deep, which checks
+// that insert, copy, height and remove no longer recurse. The last rows
+// load sorted snapshots with fromSorted and merge two of them with
+// mergeWith
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../Trees/binary-search-tree.hpp"
+#include "bench.hpp"
+
+template <typename Tree>
+void run(const char* tree_name, const char* order,
+         const std::vector<int>& keys) {
+  size_t n = keys.size();
+  char label[64];
+  Tree tree;
+
+  snprintf(label, sizeof label, "%s insert (%s)", tree_name, order);
+  report(label, n, time_ns([&] {
+           for (int key : keys) tree.insert(key);
+         }, 1),
+         n);
+  size_t height = tree.height();
+
+  snprintf(label, sizeof label, "%s contains (%s)", tree_name, order);
+  report(label, n, time_ns([&] {
+           size_t found = 0;
+           for (int key : keys) found += tree.contains(key);
+           do_not_optimize(found);
+         }, 1),
+         n);
+
+  snprintf(label, sizeof label, "%s remove (%s)", tree_name, order);
+  report(label, n, time_ns([&] {
+           for (int key : keys) tree.remove(key);
+         }, 1),
+         n);
+  printf("  height after insert: %zu\n", height);
+}
+
+int main() {
+  std::mt19937 rng(42);
+
+  for (size_t n = 1000; n <= 1000000; n *= 10) {
+    std::vector<int> sorted(n);
+    for (size_t i = 0; i < n; i++) sorted[i] = static_cast<int>(i);
+    std::vector<int> reversed(sorted.rbegin(), sorted.rend());
+    std::vector<int> shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    if (n <= 10000) {
+      run<BinarySearchTree<int>>("BST", "sorted", sorted);
+      run<BinarySearchTree<int>>("BST", "reverse", reversed);
+    }
+    run<BinarySearchTree<int>>("BST", "random", shuffled);
+    run<AVLTree<int>>("AVLTree", "sorted", sorted);
+    run<AVLTree<int>>("AVLTree", "reverse", reversed);
+    run<AVLTree<int>>("AVLTree", "random", shuffled);
+  }
+
+  // Deeper than the call stack allows recursion on
+  {
+    const size_t depth = 100000;
+    BinarySearchTree<int> chain;
+    report("BST insert (sorted, chain)", depth, time_ns([&] {
+             for (size_t i = 0; i < depth; i++) {
+               chain.insert(static_cast<int>(i));
+             }
+           }, 1),
+           depth);
+    BinarySearchTree<int> copy(chain);
+    printf("  height: %zu, copy height: %zu\n", chain.height(),
+           copy.height());
+    report("BST remove (sorted, chain, from the top)", depth, time_ns([&] {
+             for (size_t i = 0; i < depth; i++) {
+               chain.remove(static_cast<int>(i));
+             }
+           }, 1),
+           depth);
+  }
+
+  for (size_t n = 1000000; n <= 10000000; n *= 10) {
+    std::vector<int> evens(n);
+    std::vector<int> odds(n);
+    for (size_t i = 0; i < n; i++) {
+      evens[i] = static_cast<int>(2 * i);
+      odds[i] = static_cast<int>(2 * i + 1);
+    }
+
+    AVLTree<int> tree;
+    report("AVLTree fromSorted", n, time_ns([&] {
+             tree = AVLTree<int>::fromSorted(evens.begin(), evens.end());
+           }, 1),
+           n);
+
+    AVLTree<int> other = AVLTree<int>::fromSorted(odds.begin(), odds.end());
+    report("AVLTree mergeWith", 2 * n, time_ns([&] {
+             tree.mergeWith(other);
+           }, 1),
+           2 * n);
+    printf("  height after merge: %zu\n", tree.height());
+  }
+  return 0;
+}
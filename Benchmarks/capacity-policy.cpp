@@ -0,0 +1,60 @@
+// An oscillating workload, repeatedly growing to HIGH elements and draining
+// to LOW, under each shrink policy. ShrinkAtQuarter halves the array on
+// every dip below a quarter and doubles it again on the way up; the other
+// policies trade memory held for fewer reallocations.
+
+#include <chrono>
+
+#include "../Queue/array-based-queue.hpp"
+#include "../Stack/array-based-stack.hpp"
+#include "bench.hpp"
+
+const size_t HIGH = 1 << 20;
+const size_t LOW = HIGH / 16;
+const int CYCLES = 50;
+
+template <typename S>
+void stack(const char* name, S s) {
+  size_t peak = 0;
+  double ns = time_ns([&] {
+    for (int c = 0; c < CYCLES; c++) {
+      while (s.size() < HIGH) s.push(static_cast<int>(s.size()));
+      if (s.memory_usage() > peak) peak = s.memory_usage();
+      while (s.size() > LOW) s.pop();
+    }
+  }, 3);
+  report(name, HIGH, ns, CYCLES * (HIGH - LOW) * 2);
+  printf("  peak %zu KiB, after draining %zu KiB\n", peak / 1024,
+         s.memory_usage() / 1024);
+}
+
+template <typename Q>
+void queue(const char* name, Q q) {
+  size_t peak = 0;
+  double ns = time_ns([&] {
+    for (int c = 0; c < CYCLES; c++) {
+      while (q.size() < HIGH) q.enqueue(static_cast<int>(q.size()));
+      if (q.memory_usage() > peak) peak = q.memory_usage();
+      while (q.size() > LOW) do_not_optimize(q.dequeue());
+    }
+  }, 3);
+  report(name, HIGH, ns, CYCLES * (HIGH - LOW) * 2);
+  printf("  peak %zu KiB, after draining %zu KiB\n", peak / 1024,
+         q.memory_usage() / 1024);
+}
+
+int main() {
+  using Quiet = ShrinkWhenQuiet<HIGH / 2>;
+  using Delay = ShrinkAfterDelay<>;
+
+  stack("ArrayStack<ShrinkAtQuarter>", ArrayStack<int>());
+  stack("ArrayStack<NeverShrink>", ArrayStack<int, NeverShrink>());
+  stack("ArrayStack<ShrinkWhenQuiet>", ArrayStack<int, Quiet>());
+  stack("ArrayStack<ShrinkAfterDelay 100ms>", ArrayStack<int, Delay>());
+
+  queue("Queue<ShrinkAtQuarter>", Queue<int>());
+  queue("Queue<NeverShrink>", Queue<int, NeverShrink>());
+  queue("Queue<ShrinkWhenQuiet>", Queue<int, Quiet>());
+  queue("Queue<ShrinkAfterDelay 100ms>", Queue<int, Delay>());
+  return 0;
+}
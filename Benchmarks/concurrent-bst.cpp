@@ -0,0 +1,99 @@
+// Read-heavy mixed workload (95% contains, 5% insert/remove) shared by a
+// growing number of threads: ConcurrentBinarySearchTree against one
+// BinarySearchTree behind a global mutex and behind a reader-writer lock.
+// Speedups only show with as many cores as threads.
+// Build with -pthread
+
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "../Trees/binary-search-tree.hpp"
+#include "../Trees/concurrent-binary-search-tree.hpp"
+#include "bench.hpp"
+
+const unsigned KEY_RANGE = 1 << 20;
+const size_t OPS_PER_THREAD = 500000;
+
+struct MutexTree {
+  BinarySearchTree<int> tree;
+  std::mutex mutex;
+
+  bool contains(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tree.contains(key);
+  }
+  void insert(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tree.insert(key);
+  }
+  void remove(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tree.remove(key);
+  }
+};
+
+struct SharedMutexTree {
+  BinarySearchTree<int> tree;
+  std::shared_mutex mutex;
+
+  bool contains(int key) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return tree.contains(key);
+  }
+  void insert(int key) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    tree.insert(key);
+  }
+  void remove(int key) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    tree.remove(key);
+  }
+};
+
+template <typename Tree>
+void run(const char* name, unsigned threads) {
+  Tree tree;
+  std::mt19937 rng(42);
+  for (unsigned i = 0; i < KEY_RANGE / 2; i++) {
+    tree.insert(static_cast<int>(rng() % KEY_RANGE));
+  }
+
+  double ns = time_ns([&] {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+      workers.emplace_back([&tree, t] {
+        std::mt19937 local(t + 1);
+        size_t found = 0;
+        for (size_t i = 0; i < OPS_PER_THREAD; i++) {
+          int key = static_cast<int>(local() % KEY_RANGE);
+          unsigned dice = local() % 40;
+          if (dice == 0) {
+            tree.insert(key);
+          } else if (dice == 1) {
+            tree.remove(key);
+          } else {
+            found += tree.contains(key);
+          }
+        }
+        do_not_optimize(found);
+      });
+    }
+    for (std::thread& worker : workers) worker.join();
+  }, 1);
+
+  char label[64];
+  snprintf(label, sizeof label, "%s, %u threads", name, threads);
+  report(label, KEY_RANGE / 2, ns, threads * OPS_PER_THREAD);
+}
+
+int main() {
+  for (unsigned threads = 1; threads <= 8; threads *= 2) {
+    run<MutexTree>("BinarySearchTree + mutex", threads);
+    run<SharedMutexTree>("BinarySearchTree + shared_mutex", threads);
+    run<ConcurrentBinarySearchTree<int>>("ConcurrentBinarySearchTree", threads);
+  }
+  return 0;
+}
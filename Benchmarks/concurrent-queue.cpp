@@ -0,0 +1,176 @@
+// Blocking hand-off between threads: LL_Queue behind a mutex and condition
+// variable against ConcurrentQueue, whose producers and consumers take
+// separate locks and whose nodes are recycled. Consumers block in
+// wait_dequeue rather than spinning. Also counts heap allocations per
+// message once the queues are warm. Built as C++20 (the
+// bench-concurrent-queue-coroutines target) it also runs consumers that are
+// coroutines suspended in co_await pop(). Build with -pthread
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Queue/concurrent-queue.hpp"
+
+#ifdef CONCURRENT_QUEUE_COROUTINES
+#include <latch>
+#endif
+
+#include "../Queue/linked-list-based-queue.hpp"
+#include "alloc-counter.hpp"
+#include "bench.hpp"
+
+const size_t N = 2000000;
+const size_t ROUND_TRIPS = 100000;
+
+// The baseline: LL_Queue made thread-safe the usual way
+class LockedQueue {
+ public:
+  void enqueue(int item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.enqueu(item);
+    }
+    not_empty.notify_one();
+  }
+
+  void wait_dequeue(int& item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [&] { return !queue.empty(); });
+    item = queue.front();
+    queue.dequeue();
+  }
+
+ private:
+  LL_Queue<int> queue;
+  std::mutex mutex;
+  std::condition_variable not_empty;
+};
+
+// Each producer sends N / producers items and each consumer takes
+// N / consumers; prints the time and the allocations per item
+template <typename Q>
+void stream(const char* name, unsigned producers, unsigned consumers) {
+  Q queue;
+  size_t before = 0;
+  double ns = time_ns([&] {
+    before = allocation_count();
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+      threads.emplace_back([&] {
+        for (size_t i = 0; i < N / producers; i++) {
+          queue.enqueue(static_cast<int>(i));
+        }
+      });
+    }
+    for (unsigned c = 0; c < consumers; c++) {
+      threads.emplace_back([&] {
+        long long sum = 0;
+        int item;
+        for (size_t i = 0; i < N / consumers; i++) {
+          queue.wait_dequeue(item);
+          sum += item;
+        }
+        do_not_optimize(sum);
+      });
+    }
+    for (std::thread& thread : threads) thread.join();
+  }, 3);
+
+  // Thread creation allocates a few times per run as well
+  report(name, N, ns, N);
+  printf("  allocations/item (last run) %.3f\n",
+         double(allocation_count() - before) / N);
+}
+
+template <typename Q>
+void pingPong(const char* name) {
+  Q there;
+  Q back;
+  double ns = time_ns([&] {
+    std::thread echo([&] {
+      int item;
+      for (size_t i = 0; i < ROUND_TRIPS; i++) {
+        there.wait_dequeue(item);
+        back.enqueue(item);
+      }
+    });
+    int item;
+    for (size_t i = 0; i < ROUND_TRIPS; i++) {
+      there.enqueue(static_cast<int>(i));
+      back.wait_dequeue(item);
+    }
+    echo.join();
+  }, 1);
+  report(name, ROUND_TRIPS, ns, ROUND_TRIPS);
+}
+
+#ifdef CONCURRENT_QUEUE_COROUTINES
+// A coroutine that starts right away and frees itself when it returns
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { abort(); }
+  };
+};
+
+Detached consume(ConcurrentQueue<int>& queue, size_t count,
+                 std::atomic<long long>& total, std::latch& done) {
+  long long sum = 0;
+  for (size_t i = 0; i < count; i++) {
+    sum += co_await queue.pop();
+  }
+  total.fetch_add(sum, std::memory_order_relaxed);
+  done.count_down();
+}
+
+// Like stream(), but each consumer is a coroutine started on this thread.
+// It runs on whichever producer thread hands it an element
+void streamCoroutines(const char* name, unsigned producers,
+                      unsigned consumers) {
+  ConcurrentQueue<int> queue;
+  std::atomic<long long> total{0};
+  double ns = time_ns([&] {
+    std::latch done(consumers);
+    for (unsigned c = 0; c < consumers; c++) {
+      consume(queue, N / consumers, total, done);
+    }
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+      threads.emplace_back([&] {
+        for (size_t i = 0; i < N / producers; i++) {
+          queue.enqueue(static_cast<int>(i));
+        }
+      });
+    }
+    for (std::thread& thread : threads) thread.join();
+    done.wait();
+  }, 3);
+  do_not_optimize(total.load());
+  report(name, N, ns, N);
+}
+#endif
+
+int main() {
+  printf("throughput\n");
+  stream<LockedQueue>("LL_Queue + mutex/condvar, 1p1c", 1, 1);
+  stream<ConcurrentQueue<int>>("ConcurrentQueue, 1p1c", 1, 1);
+  stream<LockedQueue>("LL_Queue + mutex/condvar, 4p4c", 4, 4);
+  stream<ConcurrentQueue<int>>("ConcurrentQueue, 4p4c", 4, 4);
+
+  printf("round-trip latency\n");
+  pingPong<LockedQueue>("LL_Queue + mutex/condvar");
+  pingPong<ConcurrentQueue<int>>("ConcurrentQueue");
+
+#ifdef CONCURRENT_QUEUE_COROUTINES
+  printf("coroutine consumers (co_await pop())\n");
+  streamCoroutines("ConcurrentQueue, 1p1c", 1, 1);
+  streamCoroutines("ConcurrentQueue, 4p4c", 4, 4);
+#endif
+  return 0;
+}
@@ -0,0 +1,68 @@
+// Lookups in a frozen EytzingerIndex against the AVLTree it was built from
+// and a binary search over a sorted vector. Sizes run from 1M keys up to the
+// limit given as the first argument (default 10M; 100M needs several GB for
+// the tree alone)
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../Trees/binary-search-tree.hpp"
+#include "bench.hpp"
+
+int main(int argc, char** argv) {
+  size_t limit = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+  std::mt19937 rng(42);
+
+  for (size_t n = 1000000; n <= limit; n *= 10) {
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) keys[i] = static_cast<int>(i * 2);
+
+    // Half of the probes miss
+    std::vector<int> probes(1000000);
+    for (int& probe : probes) probe = static_cast<int>(rng() % (2 * n));
+
+    AVLTree<int> tree = AVLTree<int>::fromSorted(keys.begin(), keys.end());
+    EytzingerIndex<int> index;
+    report("AVLTree freeze", n, time_ns([&] { index = tree.freeze(); }, 1),
+           n);
+
+    report("AVLTree contains", n, time_ns([&] {
+             size_t found = 0;
+             for (int probe : probes) found += tree.contains(probe);
+             do_not_optimize(found);
+           }),
+           probes.size());
+
+    report("sorted vector binary_search", n, time_ns([&] {
+             size_t found = 0;
+             for (int probe : probes) {
+               found += std::binary_search(keys.begin(), keys.end(), probe);
+             }
+             do_not_optimize(found);
+           }),
+           probes.size());
+
+    report("EytzingerIndex contains", n, time_ns([&] {
+             size_t found = 0;
+             for (int probe : probes) found += index.contains(probe);
+             do_not_optimize(found);
+           }),
+           probes.size());
+
+    report("AVLTree rank", n, time_ns([&] {
+             size_t total = 0;
+             for (int probe : probes) total += tree.rank(probe);
+             do_not_optimize(total);
+           }),
+           probes.size());
+
+    report("EytzingerIndex rank", n, time_ns([&] {
+             size_t total = 0;
+             for (int probe : probes) total += index.rank(probe);
+             do_not_optimize(total);
+           }),
+           probes.size());
+  }
+  return 0;
+}
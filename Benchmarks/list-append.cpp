@@ -0,0 +1,42 @@
+// Building a singly linked List by appending: with the cached tail the cost
+// per push_back stays flat as the list grows, and splicing is O(1)
+
+#include <forward_list>
+
+#include "../Linked Lists/singly-linked-list.hpp"
+#include "bench.hpp"
+
+int main() {
+  for (size_t n = 1000; n <= 10000000; n *= 10) {
+    report("List<int>::push_back", n, time_ns([&] {
+             List<int> list;
+             for (size_t i = 0; i < n; i++) {
+               list.push_back(static_cast<int>(i));
+             }
+             do_not_optimize(list.size());
+           }, 3),
+           n);
+
+    report("std::forward_list<int> append", n, time_ns([&] {
+             std::forward_list<int> list;
+             auto last = list.before_begin();
+             for (size_t i = 0; i < n; i++) {
+               last = list.insert_after(last, static_cast<int>(i));
+             }
+             do_not_optimize(list.front());
+           }, 3),
+           n);
+  }
+
+  // Splicing two large lists only relinks the tail
+  const size_t n = 1000000;
+  List<int> first;
+  List<int> second;
+  for (size_t i = 0; i < n; i++) {
+    first.push_back(static_cast<int>(i));
+    second.push_back(static_cast<int>(i));
+  }
+  report("List<int>::splice", n, time_ns([&] { first.splice(second); }, 1),
+         1);
+  return 0;
+}
@@ -0,0 +1,75 @@
+// A stack shared by 1-8 threads, each pushing and popping in pairs:
+// LL_Stack behind a mutex against LockFreeStack with and without the
+// elimination array. Elimination only pays off when threads really run
+// at once, so the scaling needs as many cores as threads. Build with
+// -pthread
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Stack/linked-list-based-stack.hpp"
+#include "../Stack/lock-free-stack.hpp"
+#include "bench.hpp"
+
+const size_t OPS_PER_THREAD = 1000000;
+
+// The baseline: LL_Stack made thread-safe the usual way
+class LockedStack {
+ public:
+  void push(int item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    stack.push(item);
+  }
+
+  bool try_pop(int& item) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stack.empty()) {
+      return false;
+    }
+    item = stack.top();
+    stack.pop();
+    return true;
+  }
+
+ private:
+  LL_Stack<int> stack;
+  std::mutex mutex;
+};
+
+template <typename S>
+void run(const char* name, unsigned threads) {
+  S stack;
+  // Keep the stack from running dry, as a free list in steady use would
+  for (int i = 0; i < 1024; i++) stack.push(i);
+
+  double ns = time_ns([&] {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+      workers.emplace_back([&] {
+        long long sum = 0;
+        int item;
+        for (size_t i = 0; i < OPS_PER_THREAD / 2; i++) {
+          stack.push(static_cast<int>(i));
+          if (stack.try_pop(item)) sum += item;
+        }
+        do_not_optimize(sum);
+      });
+    }
+    for (std::thread& worker : workers) worker.join();
+  }, 3);
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s, %u threads", name, threads);
+  report(label, threads * OPS_PER_THREAD, ns, threads * OPS_PER_THREAD);
+}
+
+int main() {
+  printf("%u cores\n", std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= 8; threads *= 2) {
+    run<LockedStack>("LL_Stack + mutex", threads);
+    run<LockFreeStack<int, 0>>("LockFreeStack, no elimination", threads);
+    run<LockFreeStack<int>>("LockFreeStack", threads);
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+// Moving data through the array Queue one element at a time versus in
+// batches with enqueue_bulk/dequeue_bulk, and consuming it in place through
+// peek_spans
+
+#include <string.h>
+
+#include <vector>
+
+#include "../Queue/array-based-queue.hpp"
+#include "bench.hpp"
+
+template <typename T, typename Make>
+void compare(const char* type_name, size_t n, size_t batch, Make make) {
+  std::vector<T> input;
+  for (size_t i = 0; i < batch; i++) input.push_back(make(i));
+  std::vector<T> output(batch);
+  const size_t rounds = n / batch;
+  char name[96];
+
+  Queue<T> single(batch);
+  snprintf(name, sizeof(name), "Queue<%s> enqueue/dequeue x%zu", type_name,
+           batch);
+  report(name, n, time_ns([&] {
+           for (size_t r = 0; r < rounds; r++) {
+             for (size_t i = 0; i < batch; i++) single.enqueue(input[i]);
+             for (size_t i = 0; i < batch; i++) output[i] = single.dequeue();
+           }
+           do_not_optimize(output[0]);
+         }),
+         rounds * batch);
+
+  Queue<T> bulk(batch);
+  snprintf(name, sizeof(name), "Queue<%s> enqueue_bulk/dequeue_bulk x%zu",
+           type_name, batch);
+  report(name, n, time_ns([&] {
+           for (size_t r = 0; r < rounds; r++) {
+             bulk.enqueue_bulk(input.begin(), input.end());
+             bulk.dequeue_bulk(output.begin(), batch);
+           }
+           do_not_optimize(output[0]);
+         }),
+         rounds * batch);
+}
+
+int main() {
+  const size_t n = 16000000;
+
+  for (size_t batch : {16, 256, 4096}) {
+    compare<int>("int", n, batch, [](size_t i) { return static_cast<int>(i); });
+  }
+  compare<std::vector<int>>("vector<int>", n / 16, 256,
+                            [](size_t i) { return std::vector<int>(1, i); });
+
+  // A byte stream handed to a consumer that copies whole runs, as a write()
+  // into a socket or file would, versus popping byte by byte
+  const size_t chunk = 4096;
+  std::vector<char> bytes(chunk, 'x');
+  std::vector<char> sink(chunk);
+  Queue<char> stream(2 * chunk);
+
+  report("Queue<char> dequeue x4096", n, time_ns([&] {
+           for (size_t r = 0; r < n / chunk; r++) {
+             stream.enqueue_bulk(bytes.begin(), bytes.end());
+             for (size_t i = 0; i < chunk; i++) sink[i] = stream.dequeue();
+           }
+           do_not_optimize(sink[0]);
+         }),
+         n);
+  report("Queue<char> peek_spans + discard x4096", n, time_ns([&] {
+           for (size_t r = 0; r < n / chunk; r++) {
+             stream.enqueue_bulk(bytes.begin(), bytes.end());
+             auto spans = stream.peek_spans();
+             memcpy(sink.data(), spans.first.data, spans.first.size);
+             memcpy(sink.data() + spans.first.size, spans.second.data,
+                    spans.second.size);
+             stream.discard(spans.first.size + spans.second.size);
+           }
+           do_not_optimize(sink[0]);
+         }),
+         n);
+  return 0;
+}
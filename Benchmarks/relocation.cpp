@@ -0,0 +1,104 @@
+// Buffer growth the old way (new T[] plus an element-wise move-assign loop)
+// versus raw storage plus relocate_elements, and the resulting growth cost of
+// Vector, ArrayStack and Queue
+
+#include <memory>
+#include <vector>
+
+#include "../Dynamic Arrays/Vector.hpp"
+#include "../Queue/array-based-queue.hpp"
+#include "../Stack/array-based-stack.hpp"
+#include "../Utility/trivially-relocatable.hpp"
+#include "bench.hpp"
+
+struct Point {
+  double x, y, z;
+};
+
+// The old growth path: default-construct a new array, move-assign into it
+template <typename T>
+T* grow_by_assignment(T* from, size_t count) {
+  T* to = new T[count];
+  for (size_t i = 0; i < count; i++) {
+    to[i] = std::move(from[i]);
+  }
+  delete[] from;
+  return to;
+}
+
+// The new growth path: raw storage filled by relocate_elements
+template <typename T>
+T* grow_by_relocation(T* from, size_t count) {
+  std::allocator<T> alloc;
+  T* to = alloc.allocate(count);
+  relocate_elements(from, count, to);
+  alloc.deallocate(from, count);
+  return to;
+}
+
+template <typename T, typename Make>
+void compare(const char* type_name, size_t n, Make make) {
+  const int rounds = 8;
+  char name[64];
+
+  T* array = new T[n];
+  for (size_t i = 0; i < n; i++) array[i] = make(i);
+  snprintf(name, sizeof name, "new[] + move-assign <%s>", type_name);
+  double loop_ns = time_ns([&] {
+    for (int r = 0; r < rounds; r++) array = grow_by_assignment(array, n);
+  });
+  report(name, n, loop_ns, rounds * n);
+  delete[] array;
+
+  std::allocator<T> alloc;
+  array = alloc.allocate(n);
+  for (size_t i = 0; i < n; i++) {
+    ::new (static_cast<void*>(array + i)) T(make(i));
+  }
+  snprintf(name, sizeof name, "relocate_elements <%s>", type_name);
+  double relocate_ns = time_ns([&] {
+    for (int r = 0; r < rounds; r++) array = grow_by_relocation(array, n);
+  });
+  report(name, n, relocate_ns, rounds * n);
+  printf("  speedup %.2fx\n", loop_ns / relocate_ns);
+  for (size_t i = 0; i < n; i++) array[i].~T();
+  alloc.deallocate(array, n);
+}
+
+int main() {
+  const size_t n = 4000000;
+
+  compare<int>("int", n, [](size_t i) { return static_cast<int>(i); });
+  compare<Point>("Point", n, [](size_t i) {
+    return Point{double(i), 0, 0};
+  });
+  compare<std::unique_ptr<int>>("unique_ptr<int>", n / 4, [](size_t i) {
+    return std::unique_ptr<int>(new int(static_cast<int>(i)));
+  });
+
+  report("Vector<int>::push_back (growth)", n, time_ns([&] {
+           Vector<int> v;
+           for (size_t i = 0; i < n; i++) v.push_back(static_cast<int>(i));
+           do_not_optimize(v.back());
+         }),
+         n);
+  report("ArrayStack<int>::push (growth)", n, time_ns([&] {
+           ArrayStack<int> s;
+           for (size_t i = 0; i < n; i++) s.push(static_cast<int>(i));
+           do_not_optimize(s.top());
+         }),
+         n);
+  report("Queue<int>::enqueue (growth)", n, time_ns([&] {
+           Queue<int> q;
+           for (size_t i = 0; i < n; i++) q.enqueue(static_cast<int>(i));
+           do_not_optimize(q.front());
+         }),
+         n);
+  report("std::vector<int>::push_back (growth)", n, time_ns([&] {
+           std::vector<int> v;
+           for (size_t i = 0; i < n; i++) v.push_back(static_cast<int>(i));
+           do_not_optimize(v.back());
+         }),
+         n);
+  return 0;
+}
@@ -0,0 +1,163 @@
+// Hand-off between threads: the array Queue behind a mutex and condition
+// variable against SPSCQueue and MPMCQueue, one element at a time and in
+// batches. Throughput streams N integers from producers to consumers;
+// latency bounces one integer between two threads through a pair of queues.
+// Waiting threads yield, so the lock-free queues also work (slowly) when
+// there are fewer cores than threads. Build with -pthread
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Queue/array-based-queue.hpp"
+#include "../Queue/mpmc-queue.hpp"
+#include "../Queue/spsc-queue.hpp"
+#include "bench.hpp"
+
+const size_t N = 4000000;
+const size_t CAPACITY = 1024;
+const size_t BATCH = 32;
+const size_t ROUND_TRIPS = 100000;
+
+// The baseline: Queue made thread-safe the usual way
+class LockedQueue {
+ public:
+  explicit LockedQueue(size_t capacity) : queue(capacity), capacity{capacity} {}
+
+  void enqueue(int item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_full.wait(lock, [&] { return queue.size() < capacity; });
+    queue.enqueue(item);
+    not_empty.notify_one();
+  }
+
+  int dequeue() {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [&] { return !queue.empty(); });
+    int item = queue.front();
+    queue.dequeue();
+    not_full.notify_one();
+    return item;
+  }
+
+ private:
+  Queue<int> queue;
+  size_t capacity;
+  std::mutex mutex;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+};
+
+template <typename Ring>
+void put(Ring& ring, int item) {
+  while (!ring.try_enqueue(item)) std::this_thread::yield();
+}
+
+template <typename Ring>
+int take(Ring& ring) {
+  int item;
+  while (!ring.try_dequeue(item)) std::this_thread::yield();
+  return item;
+}
+
+void put(LockedQueue& queue, int item) { queue.enqueue(item); }
+int take(LockedQueue& queue) { return queue.dequeue(); }
+
+// Run producers and consumers over one queue, each producer sending
+// N / producers items; returns the elapsed nanoseconds
+template <typename Q, typename Producer, typename Consumer>
+double stream(Q& queue, unsigned producers, unsigned consumers,
+              Producer produce, Consumer consume) {
+  return time_ns([&] {
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+      threads.emplace_back([&] { produce(queue, N / producers); });
+    }
+    for (unsigned c = 0; c < consumers; c++) {
+      threads.emplace_back([&] { consume(queue, N / consumers); });
+    }
+    for (std::thread& thread : threads) thread.join();
+  }, 1);
+}
+
+template <typename Q>
+void single(const char* name, unsigned producers, unsigned consumers) {
+  Q queue(CAPACITY);
+  double ns = stream(
+      queue, producers, consumers,
+      [](Q& q, size_t count) {
+        for (size_t i = 0; i < count; i++) put(q, static_cast<int>(i));
+      },
+      [](Q& q, size_t count) {
+        long long sum = 0;
+        for (size_t i = 0; i < count; i++) sum += take(q);
+        do_not_optimize(sum);
+      });
+  report(name, N, ns, N);
+}
+
+template <typename Q>
+void batched(const char* name, unsigned producers, unsigned consumers) {
+  Q queue(CAPACITY);
+  double ns = stream(
+      queue, producers, consumers,
+      [](Q& q, size_t count) {
+        int items[BATCH];
+        for (size_t i = 0; i < BATCH; i++) items[i] = static_cast<int>(i);
+        for (size_t sent = 0; sent < count;) {
+          size_t want = count - sent < BATCH ? count - sent : BATCH;
+          size_t done = q.try_enqueue_bulk(items, want);
+          if (done == 0) std::this_thread::yield();
+          sent += done;
+        }
+      },
+      [](Q& q, size_t count) {
+        int items[BATCH];
+        long long sum = 0;
+        for (size_t received = 0; received < count;) {
+          size_t want = count - received < BATCH ? count - received : BATCH;
+          size_t done = q.try_dequeue_bulk(items, want);
+          if (done == 0) std::this_thread::yield();
+          for (size_t i = 0; i < done; i++) sum += items[i];
+          received += done;
+        }
+        do_not_optimize(sum);
+      });
+  report(name, N, ns, N);
+}
+
+template <typename Q>
+void pingPong(const char* name) {
+  Q there(CAPACITY);
+  Q back(CAPACITY);
+  double ns = time_ns([&] {
+    std::thread echo([&] {
+      for (size_t i = 0; i < ROUND_TRIPS; i++) put(back, take(there));
+    });
+    for (size_t i = 0; i < ROUND_TRIPS; i++) {
+      put(there, static_cast<int>(i));
+      take(back);
+    }
+    echo.join();
+  }, 1);
+  report(name, ROUND_TRIPS, ns, ROUND_TRIPS);
+}
+
+int main() {
+  printf("throughput\n");
+  single<LockedQueue>("Queue + mutex/condvar, 1p1c", 1, 1);
+  single<SPSCQueue<int>>("SPSCQueue, 1p1c", 1, 1);
+  batched<SPSCQueue<int>>("SPSCQueue bulk, 1p1c", 1, 1);
+  single<MPMCQueue<int>>("MPMCQueue, 1p1c", 1, 1);
+  batched<MPMCQueue<int>>("MPMCQueue bulk, 1p1c", 1, 1);
+  single<LockedQueue>("Queue + mutex/condvar, 2p2c", 2, 2);
+  single<MPMCQueue<int>>("MPMCQueue, 2p2c", 2, 2);
+  batched<MPMCQueue<int>>("MPMCQueue bulk, 2p2c", 2, 2);
+
+  printf("round-trip latency\n");
+  pingPong<LockedQueue>("Queue + mutex/condvar");
+  pingPong<SPSCQueue<int>>("SPSCQueue");
+  pingPong<MPMCQueue<int>>("MPMCQueue");
+  return 0;
+}
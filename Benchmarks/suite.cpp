@@ -0,0 +1,798 @@
+// Benchmark suite over every container in the repository, each next to its
+// std:: counterpart, for three element types at sizes growing by powers of
+// ten. The families and what they measure:
+//
+//   sequences  push_back, random access, insert in the middle, traversal
+//   stacks     push n, then pop n
+//   queues     enqueue n, then dequeue n
+//   sets       insert n in random order, n random lookups, traversal
+//
+// Each row gives ns/op, heap allocations/op and the peak RSS of the case.
+// On POSIX systems every case runs in its own child process, so the peak
+// RSS is the case's own plus the few MiB of the idle program. Cases that
+// build a container also destroy it inside the timed region. The
+// concurrent containers are measured from one thread, without contention.
+//
+//   suite [--min-size N] [--max-size N] [--filter TEXT] [--repetitions N]
+//
+// Sizes run from --min-size (100) to --max-size (1e6). The default stops
+// at 1e6 to keep a full run short: at 1e7 a single random-order set insert
+// case takes minutes, and at 1e8 the node-based containers of strings and
+// records need far more memory than a typical machine has. --max-size 1e8
+// runs, but skips every case whose peak RSS at the previous size, scaled
+// up, would not fit in memory. --filter keeps the cases whose name
+// contains TEXT, e.g. "<int>" or "Queue". Operations that cost O(n) each
+// on some of the containers, random access into a list and insertion in
+// the middle, run slow_ops(n) times per case rather than n, and just once
+// from n = 2^26 on.
+//
+// Both linked lists are named List, so one program cannot hold both; built
+// with -DSUITE_DOUBLY_LINKED_LIST the suite runs only the sequences, with
+// the doubly linked List. Build with -pthread.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <random>
+#include <set>
+#include <stack>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define SUITE_FORK 1
+#else
+#define SUITE_FORK 0
+#endif
+
+#include "../Dynamic Arrays/SmallVector.hpp"
+#include "../Dynamic Arrays/Vector.hpp"
+#ifdef SUITE_DOUBLY_LINKED_LIST
+#include "../Linked Lists/doubly-linked-list.hpp"
+#define LIST_LABEL "List(doubly)"
+#else
+#include "../Linked Lists/singly-linked-list.hpp"
+#define LIST_LABEL "List"
+#endif
+#include "../Linked Lists/unrolled-linked-list.hpp"
+#include "../Queue/array-based-queue.hpp"
+#include "../Queue/concurrent-queue.hpp"
+#include "../Queue/linked-list-based-queue.hpp"
+#include "../Queue/mpmc-queue.hpp"
+#include "../Queue/segmented-queue.hpp"
+#include "../Queue/spsc-queue.hpp"
+#include "../Stack/array-based-stack.hpp"
+#include "../Stack/linked-list-based-stack.hpp"
+#include "../Stack/lock-free-stack.hpp"
+#include "../Stack/segmented-stack.hpp"
+#include "../Stack/work-stealing-deque.hpp"
+#include "../Trees/b-plus-tree.hpp"
+#include "../Trees/binary-search-tree.hpp"
+#include "../Trees/concurrent-binary-search-tree.hpp"
+#include "../Trees/eytzinger-index.hpp"
+#include "alloc-counter.hpp"
+#include "bench.hpp"
+
+struct Options {
+  size_t min_size = 100;
+  size_t max_size = 1000000;
+  const char* filter = nullptr;
+  int repetitions = 3;
+};
+
+Options options;
+int failures = 0;
+
+// Element types
+
+// 64 bytes, ordered by key
+struct Record {
+  uint64_t key;
+  uint64_t payload[7];
+
+  bool operator<(const Record& rhs) const { return key < rhs.key; }
+  bool operator>(const Record& rhs) const { return key > rhs.key; }
+  bool operator==(const Record& rhs) const { return key == rhs.key; }
+};
+
+template <typename T>
+struct Element;
+
+template <>
+struct Element<int> {
+  static const char* name() { return "int"; }
+  static int make(size_t i) { return static_cast<int>(i); }
+  static uint64_t digest(int item) { return static_cast<uint64_t>(item); }
+};
+
+template <>
+struct Element<std::string> {
+  static const char* name() { return "string"; }
+
+  // 24 characters, too long for the small string buffer; zero-padded so
+  // the strings sort in the order of the numbers
+  static std::string make(size_t i) {
+    char text[32];
+    snprintf(text, sizeof text, "key-%020zu", i);
+    return text;
+  }
+
+  // Reads the heap buffer, not just the string object
+  static uint64_t digest(const std::string& item) {
+    return static_cast<unsigned char>(item[item.size() - 1]);
+  }
+};
+
+template <>
+struct Element<Record> {
+  static const char* name() { return "record"; }
+
+  static Record make(size_t i) {
+    Record record;
+    record.key = i;
+    for (size_t k = 0; k < 7; k++) record.payload[k] = i + k;
+    return record;
+  }
+
+  static uint64_t digest(const Record& item) {
+    return item.key + item.payload[6];
+  }
+};
+
+template <typename T>
+uint64_t digest(const T& item) {
+  return Element<T>::digest(item);
+}
+
+// Harness
+
+// xorshift64, for random indices and keys
+class Random {
+ public:
+  size_t below(size_t n) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<size_t>(state % n);
+  }
+
+ private:
+  uint64_t state = 0x9E3779B97F4A7C15ull;
+};
+
+// Operations that walk or shift about half the container each: enough of
+// them for about 2^26 element steps per case, at least one and at most n
+size_t slow_ops(size_t n) {
+  const size_t work = size_t(1) << 26;
+  return std::max<size_t>(1, std::min(n, work / n));
+}
+
+struct Result {
+  double ns;           // The fastest repetition
+  size_t allocations;  // In one run
+};
+
+// Run body once to count its allocations, then time it
+template <typename F>
+Result measure(F&& body) {
+  size_t before = allocation_count();
+  body();
+  size_t allocations = allocation_count() - before;
+  return Result{time_ns(body, options.repetitions), allocations};
+}
+
+// measure() for operations that change the container: setup runs untimed
+// before every run of body, so each repetition starts from the same state
+template <typename S, typename F>
+Result measure(S&& setup, F&& body) {
+  setup();
+  size_t before = allocation_count();
+  body();
+  size_t allocations = allocation_count() - before;
+
+  double best = 0;
+  for (int r = 0; r < options.repetitions; r++) {
+    setup();
+    double elapsed = time_ns(body, 1);
+    if (r == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return Result{best, allocations};
+}
+
+std::string case_name(const char* label, const char* type, const char* op) {
+  return std::string(label) + "<" + type + "> " + op;
+}
+
+void print_row(const std::string& name, size_t n, size_t ops,
+               const Result& result) {
+  printf("%-46s n=%-10zu %10.2f ns/op %8.3f allocs/op %9.1f MiB peak\n",
+         name.c_str(), n, result.ns / ops,
+         double(result.allocations) / ops, peak_rss_kib() / 1024.0);
+}
+
+#if SUITE_FORK
+// The peak RSS of each case at the last size it ran, in KiB
+struct Footprint {
+  size_t n;
+  size_t kib;
+};
+std::map<std::string, Footprint> footprints;
+
+size_t physical_memory_kib() {
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGE_SIZE);
+  if (pages <= 0 || page_size <= 0) {
+    return SIZE_MAX;
+  }
+  return static_cast<size_t>(pages) / 1024 * static_cast<size_t>(page_size);
+}
+
+// Scale the case's peak RSS at its last size up to n and skip the case, with
+// a row saying so, if that would take more than three quarters of physical
+// memory; the rest is left to the system
+bool fits_in_memory(const std::string& name, size_t n) {
+  auto last = footprints.find(name);
+  if (last == footprints.end()) {
+    return true;
+  }
+  double estimate = double(last->second.kib) * n / last->second.n;
+  if (estimate <= 0.75 * double(physical_memory_kib())) {
+    return true;
+  }
+  printf("%-46s n=%-10zu skipped, needs about %.1f GiB\n", name.c_str(), n,
+         estimate / (1024 * 1024));
+  return false;
+}
+#endif
+
+// Run one case of ops operations and print its row. bench() sets up the
+// container and returns the measure() of the operations; it runs in a
+// child process where there is fork, and is skipped if its memory use at
+// the previous size says it would not fit
+template <typename F>
+void run(const std::string& name, size_t n, size_t ops, F&& bench) {
+  if (options.filter != nullptr &&
+      name.find(options.filter) == std::string::npos) {
+    return;
+  }
+
+#if SUITE_FORK
+  if (!fits_in_memory(name, n)) {
+    return;
+  }
+
+  fflush(stdout);
+  pid_t child = fork();
+  if (child < 0) {
+    perror("fork");
+    exit(1);
+  }
+  if (child == 0) {
+    print_row(name, n, ops, bench());
+    fflush(stdout);
+    _exit(0);
+  }
+
+  int status = 0;
+  struct rusage usage;
+  wait4(child, &status, 0, &usage);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    printf("%-46s n=%-10zu failed\n", name.c_str(), n);
+    failures++;
+    return;
+  }
+#ifdef __APPLE__
+  footprints[name] = {n, static_cast<size_t>(usage.ru_maxrss) / 1024};
+#else
+  footprints[name] = {n, static_cast<size_t>(usage.ru_maxrss)};
+#endif
+#else
+  print_row(name, n, ops, bench());
+#endif
+}
+
+// Sequences
+
+enum SequenceOp {
+  PUSH_BACK = 1,
+  RANDOM_ACCESS = 2,
+  INSERT_MIDDLE = 4,
+  TRAVERSAL = 8
+};
+
+const char* op_name(SequenceOp op) {
+  switch (op) {
+    case PUSH_BACK:
+      return "push_back";
+    case RANDOM_ACCESS:
+      return "random access";
+    case INSERT_MIDDLE:
+      return "insert middle";
+    default:
+      return "traversal";
+  }
+}
+
+template <typename C>
+const auto& element_at(C& sequence, size_t index) {
+  return sequence[index];
+}
+
+template <typename T, typename A>
+const T& element_at(std::list<T, A>& list, size_t index) {
+  return *std::next(list.begin(), index);
+}
+
+template <typename C, typename T>
+void insert_middle(C& list, size_t pos, const T& item) {
+  list.insertAt(item, pos);
+}
+
+template <typename T, typename A, typename G>
+void insert_middle(Vector<T, A, G>& vector, size_t pos, const T& item) {
+  vector.insert(item, pos);
+}
+
+template <typename T, size_t N, typename A, typename G>
+void insert_middle(SmallVector<T, N, A, G>& vector, size_t pos,
+                   const T& item) {
+  vector.insert(item, pos);
+}
+
+template <typename T, typename A>
+void insert_middle(std::vector<T, A>& vector, size_t pos, const T& item) {
+  vector.insert(vector.begin() + pos, item);
+}
+
+template <typename T, typename A>
+void insert_middle(std::list<T, A>& list, size_t pos, const T& item) {
+  list.insert(std::next(list.begin(), pos), item);
+}
+
+template <typename C>
+uint64_t traverse(C& sequence) {
+  uint64_t sum = 0;
+  for (const auto& item : sequence) sum += digest(item);
+  return sum;
+}
+
+// linked: indexing walks the list, so random access runs slow_ops(n) times
+template <typename C, typename T>
+void sequence(const char* label, SequenceOp op, size_t n, bool linked) {
+  using E = Element<T>;
+  std::string name = case_name(label, E::name(), op_name(op));
+  auto fill = [n](C& sequence) {
+    for (size_t i = 0; i < n; i++) sequence.push_back(E::make(i));
+  };
+
+  switch (op) {
+    case PUSH_BACK:
+      run(name, n, n, [&] {
+        return measure([&] {
+          C sequence;
+          fill(sequence);
+          do_not_optimize(sequence.size());
+        });
+      });
+      break;
+
+    case RANDOM_ACCESS: {
+      size_t ops = linked ? slow_ops(n) : n;
+      run(name, n, ops, [&] {
+        C sequence;
+        fill(sequence);
+        return measure([&] {
+          Random random;
+          uint64_t sum = 0;
+          for (size_t k = 0; k < ops; k++) {
+            sum += digest(element_at(sequence, random.below(n)));
+          }
+          do_not_optimize(sum);
+        });
+      });
+      break;
+    }
+
+    case INSERT_MIDDLE: {
+      size_t ops = slow_ops(n);
+      run(name, n, ops, [&] {
+        // Rebuilt from scratch each time, capacity included
+        std::optional<C> sequence;
+        auto rebuild = [&] {
+          sequence.reset();
+          sequence.emplace();
+          fill(*sequence);
+        };
+        return measure(rebuild, [&] {
+          for (size_t k = 0; k < ops; k++) {
+            insert_middle(*sequence, sequence->size() / 2, E::make(k));
+          }
+        });
+      });
+      break;
+    }
+
+    default:
+      run(name, n, n, [&] {
+        C sequence;
+        fill(sequence);
+        return measure([&] { do_not_optimize(traverse(sequence)); });
+      });
+      break;
+  }
+}
+
+template <typename T>
+void sequences(size_t n) {
+  for (SequenceOp op : {PUSH_BACK, RANDOM_ACCESS, INSERT_MIDDLE, TRAVERSAL}) {
+    sequence<std::vector<T>, T>("std::vector", op, n, false);
+    sequence<Vector<T>, T>("Vector", op, n, false);
+    sequence<SmallVector<T, 16>, T>("SmallVector", op, n, false);
+    sequence<std::list<T>, T>("std::list", op, n, true);
+    sequence<List<T>, T>(LIST_LABEL, op, n, true);
+    sequence<UnrolledList<T>, T>("UnrolledList", op, n, true);
+  }
+}
+
+// Stacks and queues
+
+// Containers with a fixed capacity are created with room for n
+template <typename C>
+struct Factory {
+  static C create(size_t) { return C(); }
+};
+
+template <typename T>
+struct Factory<SPSCQueue<T>> {
+  static SPSCQueue<T> create(size_t n) { return SPSCQueue<T>(n); }
+};
+
+template <typename T>
+struct Factory<MPMCQueue<T>> {
+  static MPMCQueue<T> create(size_t n) { return MPMCQueue<T>(n); }
+};
+
+template <typename C>
+uint64_t pop_from(C& stack) {
+  uint64_t value = digest(stack.top());
+  stack.pop();
+  return value;
+}
+
+template <typename T, size_t S>
+uint64_t pop_from(LockFreeStack<T, S>& stack) {
+  T item{};
+  stack.try_pop(item);
+  return digest(item);
+}
+
+template <typename T>
+uint64_t pop_from(WorkStealingDeque<T>& deque) {
+  T item{};
+  deque.pop(item);
+  return digest(item);
+}
+
+template <typename C, typename T>
+void stack_case(const char* label, size_t n) {
+  using E = Element<T>;
+  run(case_name(label, E::name(), "push+pop"), n, 2 * n, [&] {
+    return measure([&] {
+      C stack = Factory<C>::create(n);
+      for (size_t i = 0; i < n; i++) stack.push(E::make(i));
+      uint64_t sum = 0;
+      for (size_t i = 0; i < n; i++) sum += pop_from(stack);
+      do_not_optimize(sum);
+    });
+  });
+}
+
+// WorkStealingDeque holds its elements in std::atomic<T>; a T that needs a
+// lock there is not worth measuring
+template <typename T>
+struct LockFreeAtomic
+    : std::integral_constant<bool, std::atomic<T>::is_always_lock_free> {};
+
+template <typename T>
+void stacks(size_t n) {
+  stack_case<std::stack<T>, T>("std::stack", n);
+  stack_case<ArrayStack<T>, T>("ArrayStack", n);
+  stack_case<SegmentedStack<T>, T>("SegmentedStack", n);
+  stack_case<LL_Stack<T>, T>("LL_Stack", n);
+  stack_case<LockFreeStack<T>, T>("LockFreeStack", n);
+  if constexpr (std::conjunction<std::is_trivially_copyable<T>,
+                                 LockFreeAtomic<T>>::value) {
+    stack_case<WorkStealingDeque<T>, T>("WorkStealingDeque", n);
+  }
+}
+
+template <typename C, typename U>
+void enqueue_to(C& queue, U&& item) {
+  queue.enqueue(std::forward<U>(item));
+}
+
+template <typename T, typename A, typename U>
+void enqueue_to(LL_Queue<T, A>& queue, U&& item) {
+  queue.enqueu(std::forward<U>(item));
+}
+
+template <typename T, typename S, typename U>
+void enqueue_to(std::queue<T, S>& queue, U&& item) {
+  queue.push(std::forward<U>(item));
+}
+
+template <typename T, typename U>
+void enqueue_to(SPSCQueue<T>& queue, U&& item) {
+  queue.try_enqueue(std::forward<U>(item));
+}
+
+template <typename T, typename U>
+void enqueue_to(MPMCQueue<T>& queue, U&& item) {
+  queue.try_enqueue(std::forward<U>(item));
+}
+
+template <typename C>
+uint64_t dequeue_from(C& queue) {
+  return digest(queue.dequeue());
+}
+
+template <typename T, typename A>
+uint64_t dequeue_from(LL_Queue<T, A>& queue) {
+  uint64_t value = digest(queue.front());
+  queue.dequeue();
+  return value;
+}
+
+template <typename T, typename S>
+uint64_t dequeue_from(std::queue<T, S>& queue) {
+  uint64_t value = digest(queue.front());
+  queue.pop();
+  return value;
+}
+
+template <typename T>
+uint64_t dequeue_from(ConcurrentQueue<T>& queue) {
+  T item{};
+  queue.try_dequeue(item);
+  return digest(item);
+}
+
+template <typename T>
+uint64_t dequeue_from(SPSCQueue<T>& queue) {
+  T item{};
+  queue.try_dequeue(item);
+  return digest(item);
+}
+
+template <typename T>
+uint64_t dequeue_from(MPMCQueue<T>& queue) {
+  T item{};
+  queue.try_dequeue(item);
+  return digest(item);
+}
+
+template <typename C, typename T>
+void queue_case(const char* label, size_t n) {
+  using E = Element<T>;
+  run(case_name(label, E::name(), "enqueue+dequeue"), n, 2 * n, [&] {
+    return measure([&] {
+      C queue = Factory<C>::create(n);
+      for (size_t i = 0; i < n; i++) enqueue_to(queue, E::make(i));
+      uint64_t sum = 0;
+      for (size_t i = 0; i < n; i++) sum += dequeue_from(queue);
+      do_not_optimize(sum);
+    });
+  });
+}
+
+template <typename T>
+void queues(size_t n) {
+  queue_case<std::queue<T>, T>("std::queue", n);
+  queue_case<Queue<T>, T>("Queue", n);
+  queue_case<SegmentedQueue<T>, T>("SegmentedQueue", n);
+  queue_case<LL_Queue<T>, T>("LL_Queue", n);
+  queue_case<ConcurrentQueue<T>, T>("ConcurrentQueue", n);
+  queue_case<SPSCQueue<T>, T>("SPSCQueue", n);
+  queue_case<MPMCQueue<T>, T>("MPMCQueue", n);
+}
+
+// Ordered sets
+
+enum SetOp { INSERT = 1, LOOKUP = 2, IN_ORDER = 4, ALL_SET_OPS = 7 };
+
+const char* op_name(SetOp op) {
+  switch (op) {
+    case INSERT:
+      return "insert";
+    case LOOKUP:
+      return "lookup";
+    default:
+      return "traversal";
+  }
+}
+
+// 0 .. n-1 shuffled, the same for every container
+std::vector<uint32_t> random_order(size_t n) {
+  std::vector<uint32_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+  return order;
+}
+
+template <typename T, typename C>
+void fill_set(C& set, const std::vector<uint32_t>& order) {
+  for (uint32_t i : order) set.insert(Element<T>::make(i));
+}
+
+// Built in one go from the sorted keys
+template <typename T>
+void fill_set(EytzingerIndex<T>& index, const std::vector<uint32_t>& order) {
+  std::vector<T> sorted;
+  sorted.reserve(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    sorted.push_back(Element<T>::make(i));
+  }
+  index = EytzingerIndex<T>(sorted.begin(), sorted.end());
+}
+
+template <typename C, typename T>
+bool holds(const C& set, const T& key) {
+  return set.contains(key);
+}
+
+template <typename T, typename L, typename A>
+bool holds(const std::set<T, L, A>& set, const T& key) {
+  return set.find(key) != set.end();
+}
+
+// The trees' traversals take a plain function, so the sum is global
+uint64_t visited = 0;
+
+template <typename T, typename C>
+uint64_t traverse_set(const C& set) {
+  visited = 0;
+  set.inOrderTraversal(+[](const T& item) { visited += digest(item); });
+  return visited;
+}
+
+template <typename T, typename L, typename A>
+uint64_t traverse_set(const std::set<T, L, A>& set) {
+  uint64_t sum = 0;
+  for (const T& item : set) sum += digest(item);
+  return sum;
+}
+
+// Supported is a mask of SetOps
+template <typename C, typename T, unsigned Supported = ALL_SET_OPS>
+void set_case(const char* label, SetOp op, size_t n) {
+  if ((Supported & op) == 0) {
+    return;
+  }
+
+  using E = Element<T>;
+  std::string name = case_name(label, E::name(), op_name(op));
+
+  switch (op) {
+    case INSERT:
+      if constexpr ((Supported & INSERT) != 0) {
+        run(name, n, n, [&] {
+          std::vector<uint32_t> order = random_order(n);
+          return measure([&] {
+            C set;
+            fill_set<T>(set, order);
+            do_not_optimize(set.size());
+          });
+        });
+      }
+      break;
+
+    case LOOKUP:
+      run(name, n, n, [&] {
+        C set;
+        fill_set<T>(set, random_order(n));
+        return measure([&] {
+          Random random;
+          size_t found = 0;
+          for (size_t k = 0; k < n; k++) {
+            found += holds(set, E::make(random.below(n)));
+          }
+          do_not_optimize(found);
+        });
+      });
+      break;
+
+    default:
+      if constexpr ((Supported & IN_ORDER) != 0) {
+        run(name, n, n, [&] {
+          C set;
+          fill_set<T>(set, random_order(n));
+          return measure([&] { do_not_optimize(traverse_set<T>(set)); });
+        });
+      }
+      break;
+  }
+}
+
+template <typename T>
+void sets(size_t n) {
+  for (SetOp op : {INSERT, LOOKUP, IN_ORDER}) {
+    set_case<std::set<T>, T>("std::set", op, n);
+    set_case<BinarySearchTree<T>, T>("BinarySearchTree", op, n);
+    set_case<BinarySearchTree<T, AVLBalancing>, T>("BinarySearchTree+AVL",
+                                                   op, n);
+    set_case<BPlusTree<T>, T>("BPlusTree", op, n);
+    set_case<ConcurrentBinarySearchTree<T>, T>("ConcurrentBinarySearchTree",
+                                               op, n);
+    // Immutable, built from sorted keys: lookups only
+    set_case<EytzingerIndex<T>, T, LOOKUP>("EytzingerIndex", op, n);
+  }
+}
+
+template <typename T>
+void run_type() {
+  for (size_t n = options.min_size; n <= options.max_size; n *= 10) {
+    sequences<T>(n);
+#ifndef SUITE_DOUBLY_LINKED_LIST
+    stacks<T>(n);
+    queues<T>(n);
+    sets<T>(n);
+#endif
+  }
+}
+
+void usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [--min-size N] [--max-size N] [--filter TEXT] "
+          "[--repetitions N]\n"
+          "Sizes go from --min-size (default 1e2) to --max-size (default "
+          "1e6)\nby powers of ten. Up to 1e8 works, skipping the cases that "
+          "would not\nfit in memory.\n",
+          program);
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 == argc) usage(argv[0]);
+    const char* value = argv[++i];
+    if (strcmp(argv[i - 1], "--min-size") == 0) {
+      options.min_size = static_cast<size_t>(strtod(value, nullptr));
+    } else if (strcmp(argv[i - 1], "--max-size") == 0) {
+      options.max_size = static_cast<size_t>(strtod(value, nullptr));
+    } else if (strcmp(argv[i - 1], "--filter") == 0) {
+      options.filter = value;
+    } else if (strcmp(argv[i - 1], "--repetitions") == 0) {
+      options.repetitions = atoi(value);
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (options.min_size == 0 || options.repetitions < 1) usage(argv[0]);
+
+  run_type<int>();
+  run_type<std::string>();
+  run_type<Record>();
+
+  if (failures > 0) {
+    printf("%d cases failed\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+// Per-operation latency of the stacks and queues while they grow to N
+// elements and shrink back to empty: the array containers against the
+// segmented ones and the linked ones. The mean hides the occasional
+// reallocation that copies the whole array; the high percentiles and the
+// maximum show it. Each operation is timed on its own, so every figure
+// includes the ~20 ns cost of reading the clock.
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../Queue/array-based-queue.hpp"
+#include "../Queue/linked-list-based-queue.hpp"
+#include "../Queue/segmented-queue.hpp"
+#include "../Stack/array-based-stack.hpp"
+#include "../Stack/linked-list-based-stack.hpp"
+#include "../Stack/segmented-stack.hpp"
+#include "bench.hpp"
+
+const size_t N = 8000000;
+
+class LatencyLog {
+ public:
+  explicit LatencyLog(size_t capacity) { samples.reserve(capacity); }
+
+  template <typename F>
+  void time(F&& op) {
+    auto start = std::chrono::steady_clock::now();
+    op();
+    auto stop = std::chrono::steady_clock::now();
+    samples.push_back(static_cast<float>(
+        std::chrono::duration<double, std::nano>(stop - start).count()));
+  }
+
+  void print(const char* name) {
+    double total = 0;
+    for (float s : samples) total += s;
+    std::sort(samples.begin(), samples.end());
+    printf("%-34s mean %7.1f  p50 %7.1f  p99 %7.1f  p99.9 %8.1f  "
+           "max %11.1f ns\n",
+           name, total / samples.size(), percentile(0.5), percentile(0.99),
+           percentile(0.999), samples.back());
+    samples.clear();
+  }
+
+ private:
+  std::vector<float> samples;
+
+  double percentile(double p) const {
+    return samples[static_cast<size_t>(p * (samples.size() - 1))];
+  }
+};
+
+template <typename S>
+void stack(const char* name, LatencyLog& log) {
+  S s;
+  char label[64];
+  for (size_t i = 0; i < N; i++) {
+    log.time([&] { s.push(static_cast<int>(i)); });
+  }
+  snprintf(label, sizeof(label), "%s push", name);
+  log.print(label);
+
+  for (size_t i = 0; i < N; i++) {
+    log.time([&] { s.pop(); });
+  }
+  snprintf(label, sizeof(label), "%s pop", name);
+  log.print(label);
+}
+
+template <typename Q, typename Enqueue, typename Dequeue>
+void queue(const char* name, LatencyLog& log, Enqueue enqueue,
+           Dequeue dequeue) {
+  Q q;
+  char label[64];
+  for (size_t i = 0; i < N; i++) {
+    log.time([&] { enqueue(q, static_cast<int>(i)); });
+  }
+  snprintf(label, sizeof(label), "%s enqueue", name);
+  log.print(label);
+
+  for (size_t i = 0; i < N; i++) {
+    log.time([&] { dequeue(q); });
+  }
+  snprintf(label, sizeof(label), "%s dequeue", name);
+  log.print(label);
+}
+
+int main() {
+  LatencyLog log(N);
+  printf("N = %zu ints\n", N);
+
+  stack<ArrayStack<int>>("ArrayStack", log);
+  stack<SegmentedStack<int>>("SegmentedStack", log);
+  stack<LL_Stack<int>>("LL_Stack", log);
+
+  auto enqueue = [](auto& q, int item) { q.enqueue(item); };
+  auto dequeue = [](auto& q) { do_not_optimize(q.dequeue()); };
+  queue<Queue<int>>("Queue", log, enqueue, dequeue);
+  queue<SegmentedQueue<int>>("SegmentedQueue", log, enqueue, dequeue);
+  queue<LL_Queue<int>>(
+      "LL_Queue", log, [](LL_Queue<int>& q, int item) { q.enqueu(item); },
+      [](LL_Queue<int>& q) { q.dequeue(); });
+  return 0;
+}
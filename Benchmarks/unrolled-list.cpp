@@ -0,0 +1,53 @@
+// UnrolledList against the doubly linked List: sequential scans, indexed
+// access and middle insertion
+
+#include <sstream>
+
+#include "../Linked Lists/doubly-linked-list.hpp"
+#include "../Linked Lists/unrolled-linked-list.hpp"
+#include "bench.hpp"
+
+template <typename Container>
+void run(const char* name, size_t n) {
+  Container list;
+  for (size_t i = 0; i < n; i++) {
+    list.push_back(static_cast<int>(i));
+  }
+
+  char label[64];
+  snprintf(label, sizeof label, "%s scan (operator<<)", name);
+  report(label, n, time_ns([&] {
+           std::ostringstream out;
+           out << list;
+           do_not_optimize(out.tellp());
+         }, 3),
+         n);
+
+  // Indexed access at evenly spread positions
+  const size_t lookups = 1000;
+  snprintf(label, sizeof label, "%s operator[]", name);
+  report(label, n, time_ns([&] {
+           long sum = 0;
+           for (size_t i = 0; i < lookups; i++) {
+             sum += list[(i * 7919) % n];
+           }
+           do_not_optimize(sum);
+         }, 3),
+         lookups);
+
+  snprintf(label, sizeof label, "%s insertAt (middle)", name);
+  report(label, n, time_ns([&] {
+           for (size_t i = 0; i < lookups; i++) {
+             list.insertAt(static_cast<int>(i), list.size() / 2);
+           }
+         }, 1),
+         lookups);
+}
+
+int main() {
+  for (size_t n = 10000; n <= 1000000; n *= 10) {
+    run<List<int>>("List<int>", n);
+    run<UnrolledList<int>>("UnrolledList<int>", n);
+  }
+  return 0;
+}
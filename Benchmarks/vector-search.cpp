@@ -0,0 +1,74 @@
+// Vector search and reduction members (vectorized kernels) against the
+// scalar loops they replace. The values stay below 100 so that they, and
+// the missing value, fit every element type
+
+#include <stdint.h>
+
+#include "../Dynamic Arrays/Vector.hpp"
+#include "bench.hpp"
+
+template <typename Scalar, typename Vectorized>
+void compare_op(const char* op, const char* type_name, size_t n,
+                Scalar scalar, Vectorized vectorized) {
+  const int rounds = 20;
+  char name[64];
+
+  snprintf(name, sizeof name, "scalar %s <%s>", op, type_name);
+  double scalar_ns = time_ns([&] {
+    for (int r = 0; r < rounds; r++) do_not_optimize(scalar());
+  });
+  report(name, n, scalar_ns, rounds * n);
+
+  snprintf(name, sizeof name, "Vector::%s <%s>", op, type_name);
+  double vector_ns = time_ns([&] {
+    for (int r = 0; r < rounds; r++) do_not_optimize(vectorized());
+  });
+  report(name, n, vector_ns, rounds * n);
+  printf("  speedup %.2fx\n", scalar_ns / vector_ns);
+}
+
+template <typename T>
+void compare(const char* type_name, size_t n) {
+  Vector<T> v;
+  for (size_t i = 0; i < n; i++) {
+    v.push_back(static_cast<T>(i % 100));
+  }
+  // Searching for a value that is absent forces a full scan
+  const T missing = static_cast<T>(120);
+  const T* data = v.begin();
+  using Scalar = ScalarKernels<T>;
+
+  compare_op(
+      "find", type_name, n, [&] { return Scalar::find(data, n, missing); },
+      [&] { return v.find(missing); });
+  compare_op(
+      "count", type_name, n, [&] { return Scalar::count(data, n, missing); },
+      [&] { return v.count(missing); });
+  compare_op(
+      "min", type_name, n, [&] { return Scalar::min(data, n); },
+      [&] { return v.min(); });
+  compare_op(
+      "max", type_name, n, [&] { return Scalar::max(data, n); },
+      [&] { return v.max(); });
+  compare_op(
+      "sum", type_name, n, [&] { return Scalar::sum(data, n); },
+      [&] { return v.sum(); });
+}
+
+int main() {
+  const size_t n = 1 << 20;
+#if SIMD_KERNELS_AVX2
+  printf("kernels: %s\n", cpuHasAvx512() ? "AVX-512"
+                          : cpuHasAvx2()  ? "AVX2"
+                                          : "scalar");
+#endif
+
+  compare<int8_t>("int8_t", n);
+  compare<uint8_t>("uint8_t", n);
+  compare<int16_t>("int16_t", n);
+  compare<int32_t>("int32_t", n);
+  compare<int64_t>("int64_t", n);
+  compare<float>("float", n);
+  compare<double>("double", n);
+  return 0;
+}
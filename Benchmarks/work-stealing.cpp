@@ -0,0 +1,98 @@
+// Fork-join recursion on TaskScheduler (per-worker WorkStealingDeques)
+// against the same code run serially: fib with a serial cutoff, and a
+// parallel quicksort. Scaling needs as many cores as threads; pass the
+// largest thread count to try as the first argument. Build with -pthread
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../Stack/task-scheduler.hpp"
+#include "bench.hpp"
+
+const int FIB_N = 34;
+const int FIB_CUTOFF = 18;
+const size_t SORT_N = 10000000;
+const size_t SORT_CUTOFF = 4096;
+
+long fibSerial(int n) {
+  return n < 2 ? n : fibSerial(n - 1) + fibSerial(n - 2);
+}
+
+long fibParallel(TaskScheduler& scheduler, int n) {
+  if (n < FIB_CUTOFF) {
+    return fibSerial(n);
+  }
+
+  long left = 0;
+  TaskScheduler::TaskGroup group(scheduler);
+  group.run([&] { left = fibParallel(scheduler, n - 1); });
+  long right = fibParallel(scheduler, n - 2);
+  group.wait();
+  return left + right;
+}
+
+// Three-way partition around the middle element; returns [lt, gt)
+void partition(int* first, int* last, int*& lt, int*& gt) {
+  int pivot = first[(last - first) / 2];
+  lt = std::partition(first, last, [&](int x) { return x < pivot; });
+  gt = std::partition(lt, last, [&](int x) { return x == pivot; });
+}
+
+void sortParallel(TaskScheduler& scheduler, int* first, int* last) {
+  if (static_cast<size_t>(last - first) < SORT_CUTOFF) {
+    std::sort(first, last);
+    return;
+  }
+
+  int* lt;
+  int* gt;
+  partition(first, last, lt, gt);
+  TaskScheduler::TaskGroup group(scheduler);
+  group.run([&] { sortParallel(scheduler, first, lt); });
+  sortParallel(scheduler, gt, last);
+  group.wait();
+}
+
+int main(int argc, char** argv) {
+  unsigned max_threads = argc > 1 ? static_cast<unsigned>(atoi(argv[1]))
+                                  : std::thread::hardware_concurrency();
+  if (max_threads == 0) max_threads = 1;
+
+  std::vector<int> input(SORT_N);
+  std::mt19937 rng(42);
+  for (int& x : input) x = static_cast<int>(rng());
+  std::vector<int> data;
+
+  printf("fib(%d), %u cores\n", FIB_N, std::thread::hardware_concurrency());
+  report("serial", FIB_N, time_ns([&] { do_not_optimize(fibSerial(FIB_N)); }),
+         1);
+  for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    TaskScheduler scheduler(threads);
+    char name[64];
+    snprintf(name, sizeof(name), "TaskScheduler, %u threads", threads);
+    report(name, FIB_N, time_ns([&] {
+             do_not_optimize(fibParallel(scheduler, FIB_N));
+           }),
+           1);
+  }
+
+  printf("quicksort\n");
+  report("std::sort", SORT_N, time_ns([&] {
+           data = input;
+           std::sort(data.begin(), data.end());
+         }, 3),
+         SORT_N);
+  for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    TaskScheduler scheduler(threads);
+    char name[64];
+    snprintf(name, sizeof(name), "TaskScheduler, %u threads", threads);
+    report(name, SORT_N, time_ns([&] {
+             data = input;
+             sortParallel(scheduler, data.data(), data.data() + data.size());
+           }, 3),
+           SORT_N);
+  }
+  return 0;
+}
@@ -0,0 +1,115 @@
+#ifndef SMALL_VECTOR_H
+#define SMALL_VECTOR_H
+
+#include <stdlib.h>
+
+#include <memory>
+#include <utility>
+
+#include "vector-base.hpp"
+
+// A Vector that keeps up to N elements inline and only allocates from the
+// heap once it grows past them
+template <typename T, size_t N, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = GrowByDoubling>
+class SmallVector
+    : public VectorBase<SmallVector<T, N, Allocator, GrowthPolicy>, T,
+                        Allocator, GrowthPolicy> {
+  static_assert(N > 0, "SmallVector needs at least one inline element");
+
+  using Base = VectorBase<SmallVector<T, N, Allocator, GrowthPolicy>, T,
+                          Allocator, GrowthPolicy>;
+  using typename Base::AllocTraits;
+  using Base::allocator;
+  using Base::data;
+  using Base::m_capacity;
+  using Base::m_size;
+  friend Base;
+
+ public:
+  explicit SmallVector(size_t initSize = 0,
+                       const Allocator& alloc = Allocator())
+      : Base(inlineData(), N, alloc) {
+    this->resize(initSize);
+  }
+
+  SmallVector(const SmallVector& rhs)
+      : Base(inlineData(), N,
+             AllocTraits::select_on_container_copy_construction(
+                 rhs.allocator)) {
+    this->reserve(rhs.m_size);
+    this->copyElements(rhs);
+  }
+
+  // A heap buffer is stolen; inline elements have to be moved one by one
+  SmallVector(SmallVector&& rhs) noexcept
+      : Base(inlineData(), N, std::move(rhs.allocator)) {
+    takeFrom(rhs);
+  }
+
+  SmallVector& operator=(const SmallVector& rhs) {
+    if (this != &rhs) {
+      SmallVector copy = rhs;
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& rhs) noexcept {
+    if (this != &rhs) {
+      this->clear();
+      releaseBuffer();
+      allocator = std::move(rhs.allocator);
+      takeFrom(rhs);
+    }
+    return *this;
+  }
+
+  ~SmallVector() {
+    this->clear();
+    releaseBuffer();
+  }
+
+  bool isSmall() const { return data == inlineData(); }
+
+  // Moves the elements back inline when they fit
+  void shrink_to_fit() {
+    if (isSmall() || m_size == m_capacity) return;
+
+    T* newArray = m_size <= N ? inlineData() : this->allocate(m_size);
+    relocate_elements(allocator, data, m_size, newArray);
+    this->replaceBuffer(newArray, m_size <= N ? N : m_size);
+  }
+
+ private:
+  alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+
+  T* inlineData() const {
+    return reinterpret_cast<T*>(const_cast<unsigned char*>(inlineBuffer));
+  }
+
+  // Frees a heap buffer and goes back to the inline one
+  void releaseBuffer() {
+    if (!isSmall()) {
+      this->deallocate(data, m_capacity);
+      data = inlineData();
+      m_capacity = N;
+    }
+  }
+
+  // Expects this vector to be empty and inline
+  void takeFrom(SmallVector& rhs) {
+    if (rhs.isSmall()) {
+      relocate_elements(allocator, rhs.data, rhs.m_size, data);
+    } else {
+      data = rhs.data;
+      m_capacity = rhs.m_capacity;
+      rhs.data = rhs.inlineData();
+      rhs.m_capacity = N;
+    }
+    m_size = rhs.m_size;
+    rhs.m_size = 0;
+  }
+};
+
+#endif
@@ -3,22 +3,38 @@
 
 #include <stdlib.h>
 
-#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "vector-base.hpp"
+
+template <typename T, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = GrowByDoubling>
+class Vector
+    : public VectorBase<Vector<T, Allocator, GrowthPolicy>, T, Allocator,
+                        GrowthPolicy> {
+  using Base =
+      VectorBase<Vector<T, Allocator, GrowthPolicy>, T, Allocator,
+                 GrowthPolicy>;
+  using typename Base::AllocTraits;
+  using Base::allocator;
+  using Base::data;
+  using Base::m_capacity;
+  using Base::m_size;
+  friend Base;
 
-template <typename T>
-class Vector {
  public:
-  explicit Vector(size_t initSize = 0)
-      : m_size{initSize}, m_capacity{initSize + SPARE_CAPACITY} {
-    data = new T[m_capacity];
+  explicit Vector(size_t initSize = 0, const Allocator& alloc = Allocator())
+      : Base(nullptr, 0, alloc) {
+    this->resize(initSize);
   }
 
   Vector(const Vector& rhs)
-      : m_size{rhs.m_size}, m_capacity{rhs.m_capacity}, data{nullptr} {
-    data = new T[m_capacity];
-    for (size_t i = 0; i < m_size; i++) {
-      data[i] = rhs.data[i];
-    }
+      : Base(nullptr, 0,
+             AllocTraits::select_on_container_copy_construction(
+                 rhs.allocator)) {
+    this->reserve(rhs.m_capacity);
+    this->copyElements(rhs);
   }
 
   Vector& operator=(const Vector& rhs) {
@@ -28,82 +44,42 @@ class Vector {
   }
 
   ~Vector() {
-    delete[] data;
+    this->clear();
+    releaseBuffer();
     data = nullptr;
   }
 
   // Move semantics (added for modern C++)
-  Vector(Vector&& rhs)
-      : m_size{rhs.m_size}, m_capacity{rhs.m_capacity}, data{rhs.data} {
+  Vector(Vector&& rhs) noexcept
+      : Base(rhs.data, rhs.m_capacity, std::move(rhs.allocator)) {
+    m_size = rhs.m_size;
     rhs.data = nullptr;
     rhs.m_size = 0;
     rhs.m_capacity = 0;
   }
 
-  Vector& operator=(Vector&& rhs) {
+  Vector& operator=(Vector&& rhs) noexcept {
     std::swap(m_size, rhs.m_size);
     std::swap(m_capacity, rhs.m_capacity);
     std::swap(data, rhs.data);
+    std::swap(allocator, rhs.allocator);
     return *this;
   }
 
-  // Accessors
-  bool empty() const { return size() == 0; }
-  size_t size() const { return m_size; }
-  size_t capacity() const { return m_capacity; }
-
-  T& operator[](size_t index) const { return data[index]; }
-
-  // Modifiers
+  void shrink_to_fit() {
+    if (m_size == m_capacity) return;
 
-  void reserve(int newCapacity) {
-    if (newCapacity < m_size) return;
-
-    T* newArray = new T[newCapacity];
-
-    for (size_t i = 0; i < m_size; i++) {
-      newArray[i] = std::move(data[i]);
-    }
-
-    m_capacity = newCapacity;
-    std::swap(data, newArray);
-    delete[] newArray;
+    T* newArray = m_size > 0 ? this->allocate(m_size) : nullptr;
+    relocate_elements(allocator, data, m_size, newArray);
+    this->replaceBuffer(newArray, m_size);
   }
 
-  void push_back(const T& newValue) {
-    if (m_size == m_capacity) {
-      reserve(2 * m_capacity + 1);
-    }
-    data[m_size++] = newValue;
-  }
-
-  void push_back(T&& newValue) {
-    if (m_size == m_capacity) {
-      reserve(2 * m_capacity + 1);
+ private:
+  void releaseBuffer() {
+    if (data != nullptr) {
+      this->deallocate(data, m_capacity);
     }
-    data[m_size++] = std::move(newValue);
   }
-
-  void pop_back() { --m_size; }
-
-  T& front() const { return data[0]; };
-  T& back() const { return data[m_size - 1]; }
-
-  void clear() { m_size = 0; }
-
-  void insert(const T& value, size_t place) {
-    
-
-  }
-
-  void remove() {}
-
-  static const size_t SPARE_CAPACITY = 16;
-
- private:
-  size_t m_size;
-  size_t m_capacity;
-  T* data;
 };
 
-#endif
\ No newline at end of file
+#endif
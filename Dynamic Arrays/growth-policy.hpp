@@ -0,0 +1,39 @@
+#ifndef GROWTH_POLICY_H
+#define GROWTH_POLICY_H
+
+#include <stdlib.h>
+
+// Growth policies decide the next capacity of a full dynamic array. Each one
+// exposes grow(capacity, required, elementSize), which must return at least
+// required
+
+// Doubles the capacity (plus one, so an empty array can grow)
+struct GrowByDoubling {
+  static size_t grow(size_t capacity, size_t required, size_t) {
+    size_t next = 2 * capacity + 1;
+    return next > required ? next : required;
+  }
+};
+
+// Grows by half the capacity: more reallocations than doubling, but less
+// slack memory and freed blocks that can be reused by later growth
+struct GrowByHalf {
+  static size_t grow(size_t capacity, size_t required, size_t) {
+    size_t next = capacity + capacity / 2 + 1;
+    return next > required ? next : required;
+  }
+};
+
+// Doubles the capacity, then rounds the allocation up to a whole number of
+// pages so the slack at the end of the last page is usable
+template <size_t PageSize = 4096>
+struct GrowToPages {
+  static size_t grow(size_t capacity, size_t required, size_t elementSize) {
+    size_t next = GrowByDoubling::grow(capacity, required, elementSize);
+    size_t bytes = next * elementSize;
+    size_t pages = (bytes + PageSize - 1) / PageSize;
+    return pages * PageSize / elementSize;
+  }
+};
+
+#endif
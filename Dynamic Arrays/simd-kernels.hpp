@@ -0,0 +1,863 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <type_traits>
+
+// Search and reduction kernels over contiguous arrays, used by Vector and by
+// the in-node key search of BPlusTree.
+//
+// SimdKernels<T> is picked at compile time: integers of 1, 2, 4 or 8 bytes,
+// float and double get vector kernels, everything else gets the scalar
+// loops. There are AVX2 and AVX-512 kernels, each compiled with a target
+// attribute, so no -mavx2 or -mavx512f flag is needed; at runtime every call
+// takes the widest set the CPU reports. The AVX-512 kernels need AVX-512F
+// and BW, which every AVX-512 CPU except Xeon Phi has.
+//
+// Integer sums wrap around in T, like the scalar loop. Floating-point sums
+// are reassociated across lanes, so they may round differently from a
+// left-to-right loop; min and max do not order NaNs.
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define SIMD_KERNELS_AVX2 1
+#include <immintrin.h>
+#define SIMD_AVX2_TARGET __attribute__((target("avx2")))
+#define SIMD_AVX512_TARGET __attribute__((target("avx512f,avx512bw")))
+#else
+#define SIMD_KERNELS_AVX2 0
+#endif
+
+// Plain loops, valid for any T with ==, < and +=
+template <typename T>
+struct ScalarKernels {
+  // Index of the first element equal to value, or n when there is none
+  static size_t find(const T* data, size_t n, const T& value) {
+    for (size_t i = 0; i < n; i++) {
+      if (data[i] == value) return i;
+    }
+    return n;
+  }
+
+  static size_t count(const T* data, size_t n, const T& value) {
+    size_t matches = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (data[i] == value) ++matches;
+    }
+    return matches;
+  }
+
+  // Number of elements less than value. On sorted data this is the
+  // lower_bound index; the loop has no data-dependent branch
+  static size_t countLess(const T* data, size_t n, const T& value) {
+    size_t smaller = 0;
+    for (size_t i = 0; i < n; i++) {
+      smaller += data[i] < value;
+    }
+    return smaller;
+  }
+
+  // min and max expect n > 0
+  static T min(const T* data, size_t n) {
+    T result = data[0];
+    for (size_t i = 1; i < n; i++) {
+      if (data[i] < result) result = data[i];
+    }
+    return result;
+  }
+
+  static T max(const T* data, size_t n) {
+    T result = data[0];
+    for (size_t i = 1; i < n; i++) {
+      if (result < data[i]) result = data[i];
+    }
+    return result;
+  }
+
+  static T sum(const T* data, size_t n) {
+    T result{};
+    for (size_t i = 0; i < n; i++) {
+      result += data[i];
+    }
+    return result;
+  }
+};
+
+#if SIMD_KERNELS_AVX2
+
+inline bool cpuHasAvx2() {
+  static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+  return hasAvx2;
+}
+
+inline bool cpuHasAvx512() {
+  static const bool hasAvx512 = __builtin_cpu_supports("avx512f") &&
+                                __builtin_cpu_supports("avx512bw");
+  return hasAvx512;
+}
+
+// Integers of the given size; bool is left to the scalar loops
+template <typename T, size_t Size>
+struct IsIntegerOfSize
+    : std::integral_constant<bool, std::is_integral<T>::value &&
+                                       !std::is_same<T, bool>::value &&
+                                       sizeof(T) == Size> {};
+
+// Per-type AVX2 operations. equalMask and lessMask return one bit per lane
+template <typename T, typename Enable = void>
+struct Avx2Ops {
+  static const bool supported = false;
+};
+
+template <typename T>
+struct Avx2Ops<T, typename std::enable_if<IsIntegerOfSize<T, 1>::value>::type> {
+  using Reg = __m256i;
+  static const bool supported = true;
+  static const bool hasMinMax = true;
+  static const size_t lanes = 32;
+
+  SIMD_AVX2_TARGET static Reg load(const T* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  SIMD_AVX2_TARGET static void store(T* p, Reg r) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+  }
+  SIMD_AVX2_TARGET static Reg broadcast(T v) {
+    return _mm256_set1_epi8(static_cast<char>(v));
+  }
+  SIMD_AVX2_TARGET static Reg zero() { return _mm256_setzero_si256(); }
+  SIMD_AVX2_TARGET static unsigned equalMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+  }
+  SIMD_AVX2_TARGET static unsigned lessMask(Reg a, Reg b) {
+    if (!std::is_signed<T>::value) {
+      Reg bias = _mm256_set1_epi8(static_cast<char>(0x80));
+      a = _mm256_xor_si256(a, bias);
+      b = _mm256_xor_si256(b, bias);
+    }
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpgt_epi8(b, a)));
+  }
+  SIMD_AVX2_TARGET static Reg add(Reg a, Reg b) {
+    return _mm256_add_epi8(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm256_min_epi8(a, b)
+                                    : _mm256_min_epu8(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm256_max_epi8(a, b)
+                                    : _mm256_max_epu8(a, b);
+  }
+};
+
+template <typename T>
+struct Avx2Ops<T, typename std::enable_if<IsIntegerOfSize<T, 2>::value>::type> {
+  using Reg = __m256i;
+  static const bool supported = true;
+  static const bool hasMinMax = true;
+  static const size_t lanes = 16;
+
+  SIMD_AVX2_TARGET static Reg load(const T* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  SIMD_AVX2_TARGET static void store(T* p, Reg r) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+  }
+  SIMD_AVX2_TARGET static Reg broadcast(T v) {
+    return _mm256_set1_epi16(static_cast<short>(v));
+  }
+  SIMD_AVX2_TARGET static Reg zero() { return _mm256_setzero_si256(); }
+  // There is no 16-bit movemask: the all-ones or all-zeros lanes are
+  // narrowed to bytes first
+  SIMD_AVX2_TARGET static unsigned laneMask(Reg lanesSet) {
+    __m128i bytes = _mm_packs_epi16(_mm256_castsi256_si128(lanesSet),
+                                    _mm256_extracti128_si256(lanesSet, 1));
+    return static_cast<unsigned>(_mm_movemask_epi8(bytes));
+  }
+  SIMD_AVX2_TARGET static unsigned equalMask(Reg a, Reg b) {
+    return laneMask(_mm256_cmpeq_epi16(a, b));
+  }
+  SIMD_AVX2_TARGET static unsigned lessMask(Reg a, Reg b) {
+    if (!std::is_signed<T>::value) {
+      Reg bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+      a = _mm256_xor_si256(a, bias);
+      b = _mm256_xor_si256(b, bias);
+    }
+    return laneMask(_mm256_cmpgt_epi16(b, a));
+  }
+  SIMD_AVX2_TARGET static Reg add(Reg a, Reg b) {
+    return _mm256_add_epi16(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm256_min_epi16(a, b)
+                                    : _mm256_min_epu16(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm256_max_epi16(a, b)
+                                    : _mm256_max_epu16(a, b);
+  }
+};
+
+template <typename T>
+struct Avx2Ops<T, typename std::enable_if<IsIntegerOfSize<T, 4>::value>::type> {
+  using Reg = __m256i;
+  static const bool supported = true;
+  static const bool hasMinMax = true;
+  static const size_t lanes = 8;
+
+  SIMD_AVX2_TARGET static Reg load(const T* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  SIMD_AVX2_TARGET static void store(T* p, Reg r) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+  }
+  SIMD_AVX2_TARGET static Reg broadcast(T v) {
+    return _mm256_set1_epi32(static_cast<int>(v));
+  }
+  SIMD_AVX2_TARGET static Reg zero() { return _mm256_setzero_si256(); }
+  SIMD_AVX2_TARGET static unsigned equalMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+  }
+  // AVX2 only compares signed lanes; flipping the sign bit orders unsigned
+  // values the same way
+  SIMD_AVX2_TARGET static unsigned lessMask(Reg a, Reg b) {
+    if (!std::is_signed<T>::value) {
+      Reg bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+      a = _mm256_xor_si256(a, bias);
+      b = _mm256_xor_si256(b, bias);
+    }
+    return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))));
+  }
+  SIMD_AVX2_TARGET static Reg add(Reg a, Reg b) {
+    return _mm256_add_epi32(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm256_min_epi32(a, b)
+                                    : _mm256_min_epu32(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm256_max_epi32(a, b)
+                                    : _mm256_max_epu32(a, b);
+  }
+};
+
+// AVX2 has no 64-bit integer min/max, and emulating it does not beat the
+// scalar loop, so 64-bit integers only vectorize find, count and sum
+template <typename T>
+struct Avx2Ops<T, typename std::enable_if<IsIntegerOfSize<T, 8>::value>::type> {
+  using Reg = __m256i;
+  static const bool supported = true;
+  static const bool hasMinMax = false;
+  static const size_t lanes = 4;
+
+  SIMD_AVX2_TARGET static Reg load(const T* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  SIMD_AVX2_TARGET static void store(T* p, Reg r) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r);
+  }
+  SIMD_AVX2_TARGET static Reg broadcast(T v) {
+    return _mm256_set1_epi64x(static_cast<long long>(v));
+  }
+  SIMD_AVX2_TARGET static Reg zero() { return _mm256_setzero_si256(); }
+  SIMD_AVX2_TARGET static unsigned equalMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))));
+  }
+  SIMD_AVX2_TARGET static unsigned lessMask(Reg a, Reg b) {
+    if (!std::is_signed<T>::value) {
+      Reg bias = _mm256_set1_epi64x(static_cast<long long>(1ull << 63));
+      a = _mm256_xor_si256(a, bias);
+      b = _mm256_xor_si256(b, bias);
+    }
+    return static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a))));
+  }
+  SIMD_AVX2_TARGET static Reg add(Reg a, Reg b) {
+    return _mm256_add_epi64(a, b);
+  }
+  SIMD_AVX2_TARGET static Reg min(Reg a, Reg) { return a; }
+  SIMD_AVX2_TARGET static Reg max(Reg a, Reg) { return a; }
+};
+
+template <>
+struct Avx2Ops<float> {
+  using Reg = __m256;
+  static const bool supported = true;
+  static const bool hasMinMax = true;
+  static const size_t lanes = 8;
+
+  SIMD_AVX2_TARGET static Reg load(const float* p) {
+    return _mm256_loadu_ps(p);
+  }
+  SIMD_AVX2_TARGET static void store(float* p, Reg r) {
+    _mm256_storeu_ps(p, r);
+  }
+  SIMD_AVX2_TARGET static Reg broadcast(float v) { return _mm256_set1_ps(v); }
+  SIMD_AVX2_TARGET static Reg zero() { return _mm256_setzero_ps(); }
+  SIMD_AVX2_TARGET static unsigned equalMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+  }
+  SIMD_AVX2_TARGET static unsigned lessMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)));
+  }
+  SIMD_AVX2_TARGET static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+  SIMD_AVX2_TARGET static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+  SIMD_AVX2_TARGET static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+};
+
+template <>
+struct Avx2Ops<double> {
+  using Reg = __m256d;
+  static const bool supported = true;
+  static const bool hasMinMax = true;
+  static const size_t lanes = 4;
+
+  SIMD_AVX2_TARGET static Reg load(const double* p) {
+    return _mm256_loadu_pd(p);
+  }
+  SIMD_AVX2_TARGET static void store(double* p, Reg r) {
+    _mm256_storeu_pd(p, r);
+  }
+  SIMD_AVX2_TARGET static Reg broadcast(double v) {
+    return _mm256_set1_pd(v);
+  }
+  SIMD_AVX2_TARGET static Reg zero() { return _mm256_setzero_pd(); }
+  SIMD_AVX2_TARGET static unsigned equalMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+  }
+  SIMD_AVX2_TARGET static unsigned lessMask(Reg a, Reg b) {
+    return static_cast<unsigned>(
+        _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+  }
+  SIMD_AVX2_TARGET static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+  SIMD_AVX2_TARGET static Reg min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+  SIMD_AVX2_TARGET static Reg max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+};
+
+// Generic AVX2 loops over an Avx2Ops implementation
+template <typename T>
+struct Avx2Kernels {
+  using Ops = Avx2Ops<T>;
+  using Reg = typename Ops::Reg;
+  static const size_t lanes = Ops::lanes;
+
+  SIMD_AVX2_TARGET static size_t find(const T* data, size_t n, T value) {
+    Reg needle = Ops::broadcast(value);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      unsigned mask = Ops::equalMask(Ops::load(data + i), needle);
+      if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    for (; i < n; i++) {
+      if (data[i] == value) return i;
+    }
+    return n;
+  }
+
+  SIMD_AVX2_TARGET static size_t count(const T* data, size_t n, T value) {
+    Reg needle = Ops::broadcast(value);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      unsigned mask = Ops::equalMask(Ops::load(data + i), needle);
+      matches += __builtin_popcount(mask);
+    }
+    for (; i < n; i++) {
+      if (data[i] == value) ++matches;
+    }
+    return matches;
+  }
+
+  SIMD_AVX2_TARGET static size_t countLess(const T* data, size_t n, T value) {
+    Reg bound = Ops::broadcast(value);
+    size_t smaller = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      unsigned mask = Ops::lessMask(Ops::load(data + i), bound);
+      smaller += __builtin_popcount(mask);
+    }
+    for (; i < n; i++) {
+      smaller += data[i] < value;
+    }
+    return smaller;
+  }
+
+  // Expects n >= lanes
+  template <bool TakeMin>
+  SIMD_AVX2_TARGET static T extreme(const T* data, size_t n) {
+    Reg best = Ops::load(data);
+    size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+      Reg next = Ops::load(data + i);
+      best = TakeMin ? Ops::min(best, next) : Ops::max(best, next);
+    }
+    // The last partial block overlaps the previous one, which is harmless
+    if (i < n) {
+      Reg next = Ops::load(data + n - lanes);
+      best = TakeMin ? Ops::min(best, next) : Ops::max(best, next);
+    }
+
+    T lane[lanes];
+    Ops::store(lane, best);
+    return TakeMin ? ScalarKernels<T>::min(lane, lanes)
+                   : ScalarKernels<T>::max(lane, lanes);
+  }
+
+  // Two accumulators hide the latency of the vector add
+  SIMD_AVX2_TARGET static T sum(const T* data, size_t n) {
+    Reg first = Ops::zero();
+    Reg second = Ops::zero();
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+      first = Ops::add(first, Ops::load(data + i));
+      second = Ops::add(second, Ops::load(data + i + lanes));
+    }
+    first = Ops::add(first, second);
+
+    T lane[lanes];
+    Ops::store(lane, first);
+    T result = ScalarKernels<T>::sum(lane, lanes);
+    for (; i < n; i++) {
+      result += data[i];
+    }
+    return result;
+  }
+};
+
+// Lane mask with the first count bits set
+inline uint64_t firstLanes(size_t count) {
+  return count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+}
+
+// Per-type AVX-512 operations, for the same types as Avx2Ops. Comparisons
+// produce mask registers directly, and loadFirst reads only the first
+// count lanes (zeroing the rest), so the kernels need no scalar tail
+// The 32- and 64-bit min and max go through the masked forms with every lane
+// set: the plain intrinsics start from an uninitialized register, which
+// GCC 12 reports under -Wall
+template <typename T, typename Enable = void>
+struct Avx512Ops {
+  static const bool supported = false;
+};
+
+template <typename T>
+struct Avx512Ops<T,
+                 typename std::enable_if<IsIntegerOfSize<T, 1>::value>::type> {
+  using Reg = __m512i;
+  static const bool supported = true;
+  static const size_t lanes = 64;
+
+  SIMD_AVX512_TARGET static Reg load(const T* p) {
+    return _mm512_loadu_si512(p);
+  }
+  SIMD_AVX512_TARGET static Reg loadFirst(const T* p, size_t count) {
+    return _mm512_maskz_loadu_epi8(static_cast<__mmask64>(firstLanes(count)),
+                                   p);
+  }
+  SIMD_AVX512_TARGET static void store(T* p, Reg r) {
+    _mm512_storeu_si512(p, r);
+  }
+  SIMD_AVX512_TARGET static Reg broadcast(T v) {
+    return _mm512_set1_epi8(static_cast<char>(v));
+  }
+  SIMD_AVX512_TARGET static Reg zero() { return _mm512_setzero_si512(); }
+  SIMD_AVX512_TARGET static uint64_t equalMask(Reg a, Reg b) {
+    return _mm512_cmpeq_epi8_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static uint64_t lessMask(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_cmplt_epi8_mask(a, b)
+                                    : _mm512_cmplt_epu8_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg add(Reg a, Reg b) {
+    return _mm512_add_epi8(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_min_epi8(a, b)
+                                    : _mm512_min_epu8(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_max_epi8(a, b)
+                                    : _mm512_max_epu8(a, b);
+  }
+};
+
+template <typename T>
+struct Avx512Ops<T,
+                 typename std::enable_if<IsIntegerOfSize<T, 2>::value>::type> {
+  using Reg = __m512i;
+  static const bool supported = true;
+  static const size_t lanes = 32;
+
+  SIMD_AVX512_TARGET static Reg load(const T* p) {
+    return _mm512_loadu_si512(p);
+  }
+  SIMD_AVX512_TARGET static Reg loadFirst(const T* p, size_t count) {
+    return _mm512_maskz_loadu_epi16(static_cast<__mmask32>(firstLanes(count)),
+                                    p);
+  }
+  SIMD_AVX512_TARGET static void store(T* p, Reg r) {
+    _mm512_storeu_si512(p, r);
+  }
+  SIMD_AVX512_TARGET static Reg broadcast(T v) {
+    return _mm512_set1_epi16(static_cast<short>(v));
+  }
+  SIMD_AVX512_TARGET static Reg zero() { return _mm512_setzero_si512(); }
+  SIMD_AVX512_TARGET static uint64_t equalMask(Reg a, Reg b) {
+    return _mm512_cmpeq_epi16_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static uint64_t lessMask(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_cmplt_epi16_mask(a, b)
+                                    : _mm512_cmplt_epu16_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg add(Reg a, Reg b) {
+    return _mm512_add_epi16(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_min_epi16(a, b)
+                                    : _mm512_min_epu16(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_max_epi16(a, b)
+                                    : _mm512_max_epu16(a, b);
+  }
+};
+
+template <typename T>
+struct Avx512Ops<T,
+                 typename std::enable_if<IsIntegerOfSize<T, 4>::value>::type> {
+  using Reg = __m512i;
+  static const bool supported = true;
+  static const size_t lanes = 16;
+  static const __mmask16 allLanes = static_cast<__mmask16>(~0u);
+
+  SIMD_AVX512_TARGET static Reg load(const T* p) {
+    return _mm512_loadu_si512(p);
+  }
+  SIMD_AVX512_TARGET static Reg loadFirst(const T* p, size_t count) {
+    return _mm512_maskz_loadu_epi32(static_cast<__mmask16>(firstLanes(count)),
+                                    p);
+  }
+  SIMD_AVX512_TARGET static void store(T* p, Reg r) {
+    _mm512_storeu_si512(p, r);
+  }
+  SIMD_AVX512_TARGET static Reg broadcast(T v) {
+    return _mm512_set1_epi32(static_cast<int>(v));
+  }
+  SIMD_AVX512_TARGET static Reg zero() { return _mm512_setzero_si512(); }
+  SIMD_AVX512_TARGET static uint64_t equalMask(Reg a, Reg b) {
+    return _mm512_cmpeq_epi32_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static uint64_t lessMask(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_cmplt_epi32_mask(a, b)
+                                    : _mm512_cmplt_epu32_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg add(Reg a, Reg b) {
+    return _mm512_add_epi32(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value
+               ? _mm512_mask_min_epi32(a, allLanes, a, b)
+               : _mm512_mask_min_epu32(a, allLanes, a, b);
+  }
+  SIMD_AVX512_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value
+               ? _mm512_mask_max_epi32(a, allLanes, a, b)
+               : _mm512_mask_max_epu32(a, allLanes, a, b);
+  }
+};
+
+// Unlike AVX2, AVX-512 has 64-bit integer min and max
+template <typename T>
+struct Avx512Ops<T,
+                 typename std::enable_if<IsIntegerOfSize<T, 8>::value>::type> {
+  using Reg = __m512i;
+  static const bool supported = true;
+  static const size_t lanes = 8;
+  static const __mmask8 allLanes = static_cast<__mmask8>(~0u);
+
+  SIMD_AVX512_TARGET static Reg load(const T* p) {
+    return _mm512_loadu_si512(p);
+  }
+  SIMD_AVX512_TARGET static Reg loadFirst(const T* p, size_t count) {
+    return _mm512_maskz_loadu_epi64(static_cast<__mmask8>(firstLanes(count)),
+                                    p);
+  }
+  SIMD_AVX512_TARGET static void store(T* p, Reg r) {
+    _mm512_storeu_si512(p, r);
+  }
+  SIMD_AVX512_TARGET static Reg broadcast(T v) {
+    return _mm512_set1_epi64(static_cast<long long>(v));
+  }
+  SIMD_AVX512_TARGET static Reg zero() { return _mm512_setzero_si512(); }
+  SIMD_AVX512_TARGET static uint64_t equalMask(Reg a, Reg b) {
+    return _mm512_cmpeq_epi64_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static uint64_t lessMask(Reg a, Reg b) {
+    return std::is_signed<T>::value ? _mm512_cmplt_epi64_mask(a, b)
+                                    : _mm512_cmplt_epu64_mask(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg add(Reg a, Reg b) {
+    return _mm512_add_epi64(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg min(Reg a, Reg b) {
+    return std::is_signed<T>::value
+               ? _mm512_mask_min_epi64(a, allLanes, a, b)
+               : _mm512_mask_min_epu64(a, allLanes, a, b);
+  }
+  SIMD_AVX512_TARGET static Reg max(Reg a, Reg b) {
+    return std::is_signed<T>::value
+               ? _mm512_mask_max_epi64(a, allLanes, a, b)
+               : _mm512_mask_max_epu64(a, allLanes, a, b);
+  }
+};
+
+template <>
+struct Avx512Ops<float> {
+  using Reg = __m512;
+  static const bool supported = true;
+  static const size_t lanes = 16;
+  static const __mmask16 allLanes = static_cast<__mmask16>(~0u);
+
+  SIMD_AVX512_TARGET static Reg load(const float* p) {
+    return _mm512_loadu_ps(p);
+  }
+  SIMD_AVX512_TARGET static Reg loadFirst(const float* p, size_t count) {
+    return _mm512_maskz_loadu_ps(static_cast<__mmask16>(firstLanes(count)),
+                                 p);
+  }
+  SIMD_AVX512_TARGET static void store(float* p, Reg r) {
+    _mm512_storeu_ps(p, r);
+  }
+  SIMD_AVX512_TARGET static Reg broadcast(float v) {
+    return _mm512_set1_ps(v);
+  }
+  SIMD_AVX512_TARGET static Reg zero() { return _mm512_setzero_ps(); }
+  SIMD_AVX512_TARGET static uint64_t equalMask(Reg a, Reg b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+  }
+  SIMD_AVX512_TARGET static uint64_t lessMask(Reg a, Reg b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+  }
+  SIMD_AVX512_TARGET static Reg add(Reg a, Reg b) {
+    return _mm512_add_ps(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg min(Reg a, Reg b) {
+    return _mm512_mask_min_ps(a, allLanes, a, b);
+  }
+  SIMD_AVX512_TARGET static Reg max(Reg a, Reg b) {
+    return _mm512_mask_max_ps(a, allLanes, a, b);
+  }
+};
+
+template <>
+struct Avx512Ops<double> {
+  using Reg = __m512d;
+  static const bool supported = true;
+  static const size_t lanes = 8;
+  static const __mmask8 allLanes = static_cast<__mmask8>(~0u);
+
+  SIMD_AVX512_TARGET static Reg load(const double* p) {
+    return _mm512_loadu_pd(p);
+  }
+  SIMD_AVX512_TARGET static Reg loadFirst(const double* p, size_t count) {
+    return _mm512_maskz_loadu_pd(static_cast<__mmask8>(firstLanes(count)), p);
+  }
+  SIMD_AVX512_TARGET static void store(double* p, Reg r) {
+    _mm512_storeu_pd(p, r);
+  }
+  SIMD_AVX512_TARGET static Reg broadcast(double v) {
+    return _mm512_set1_pd(v);
+  }
+  SIMD_AVX512_TARGET static Reg zero() { return _mm512_setzero_pd(); }
+  SIMD_AVX512_TARGET static uint64_t equalMask(Reg a, Reg b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+  }
+  SIMD_AVX512_TARGET static uint64_t lessMask(Reg a, Reg b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+  }
+  SIMD_AVX512_TARGET static Reg add(Reg a, Reg b) {
+    return _mm512_add_pd(a, b);
+  }
+  SIMD_AVX512_TARGET static Reg min(Reg a, Reg b) {
+    return _mm512_mask_min_pd(a, allLanes, a, b);
+  }
+  SIMD_AVX512_TARGET static Reg max(Reg a, Reg b) {
+    return _mm512_mask_max_pd(a, allLanes, a, b);
+  }
+};
+
+// Generic AVX-512 loops over an Avx512Ops implementation. The last partial
+// block is read with loadFirst and its mask cut to the lanes in range
+template <typename T>
+struct Avx512Kernels {
+  using Ops = Avx512Ops<T>;
+  using Reg = typename Ops::Reg;
+  static const size_t lanes = Ops::lanes;
+
+  SIMD_AVX512_TARGET static size_t find(const T* data, size_t n, T value) {
+    Reg needle = Ops::broadcast(value);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      uint64_t mask = Ops::equalMask(Ops::load(data + i), needle);
+      if (mask != 0) return i + __builtin_ctzll(mask);
+    }
+    if (i < n) {
+      uint64_t mask = Ops::equalMask(Ops::loadFirst(data + i, n - i), needle) &
+                      firstLanes(n - i);
+      if (mask != 0) return i + __builtin_ctzll(mask);
+    }
+    return n;
+  }
+
+  SIMD_AVX512_TARGET static size_t count(const T* data, size_t n, T value) {
+    Reg needle = Ops::broadcast(value);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      matches += __builtin_popcountll(
+          Ops::equalMask(Ops::load(data + i), needle));
+    }
+    if (i < n) {
+      matches += __builtin_popcountll(
+          Ops::equalMask(Ops::loadFirst(data + i, n - i), needle) &
+          firstLanes(n - i));
+    }
+    return matches;
+  }
+
+  SIMD_AVX512_TARGET static size_t countLess(const T* data, size_t n,
+                                             T value) {
+    Reg bound = Ops::broadcast(value);
+    size_t smaller = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+      smaller += __builtin_popcountll(
+          Ops::lessMask(Ops::load(data + i), bound));
+    }
+    if (i < n) {
+      smaller += __builtin_popcountll(
+          Ops::lessMask(Ops::loadFirst(data + i, n - i), bound) &
+          firstLanes(n - i));
+    }
+    return smaller;
+  }
+
+  // Expects n >= lanes
+  template <bool TakeMin>
+  SIMD_AVX512_TARGET static T extreme(const T* data, size_t n) {
+    Reg best = Ops::load(data);
+    size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+      Reg next = Ops::load(data + i);
+      best = TakeMin ? Ops::min(best, next) : Ops::max(best, next);
+    }
+    // The last partial block overlaps the previous one, which is harmless
+    if (i < n) {
+      Reg next = Ops::load(data + n - lanes);
+      best = TakeMin ? Ops::min(best, next) : Ops::max(best, next);
+    }
+
+    T lane[lanes];
+    Ops::store(lane, best);
+    return TakeMin ? ScalarKernels<T>::min(lane, lanes)
+                   : ScalarKernels<T>::max(lane, lanes);
+  }
+
+  // The zeroed lanes of the last partial block add nothing
+  SIMD_AVX512_TARGET static T sum(const T* data, size_t n) {
+    Reg first = Ops::zero();
+    Reg second = Ops::zero();
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+      first = Ops::add(first, Ops::load(data + i));
+      second = Ops::add(second, Ops::load(data + i + lanes));
+    }
+    if (i + lanes <= n) {
+      first = Ops::add(first, Ops::load(data + i));
+      i += lanes;
+    }
+    if (i < n) {
+      second = Ops::add(second, Ops::loadFirst(data + i, n - i));
+    }
+    first = Ops::add(first, second);
+
+    T lane[lanes];
+    Ops::store(lane, first);
+    return ScalarKernels<T>::sum(lane, lanes);
+  }
+};
+
+template <typename T, bool Vectorized = Avx2Ops<T>::supported>
+struct SimdKernels : ScalarKernels<T> {};
+
+// Each call takes the widest kernels the CPU runs. Inputs shorter than one
+// vector are not worth the dispatch and go to the next narrower set
+template <typename T>
+struct SimdKernels<T, true> {
+  using Scalar = ScalarKernels<T>;
+  using Avx2 = Avx2Kernels<T>;
+  using Avx512 = Avx512Kernels<T>;
+
+  static bool useAvx512(size_t n) {
+    return n >= Avx512::lanes && cpuHasAvx512();
+  }
+
+  static bool useAvx2(size_t n) { return n >= Avx2::lanes && cpuHasAvx2(); }
+
+  static size_t find(const T* data, size_t n, const T& value) {
+    return useAvx512(n) ? Avx512::find(data, n, value)
+           : useAvx2(n) ? Avx2::find(data, n, value)
+                        : Scalar::find(data, n, value);
+  }
+
+  static size_t count(const T* data, size_t n, const T& value) {
+    return useAvx512(n) ? Avx512::count(data, n, value)
+           : useAvx2(n) ? Avx2::count(data, n, value)
+                        : Scalar::count(data, n, value);
+  }
+
+  static size_t countLess(const T* data, size_t n, const T& value) {
+    return useAvx512(n) ? Avx512::countLess(data, n, value)
+           : useAvx2(n) ? Avx2::countLess(data, n, value)
+                        : Scalar::countLess(data, n, value);
+  }
+
+  static T min(const T* data, size_t n) {
+    return useAvx512(n) ? Avx512::template extreme<true>(data, n)
+           : Avx2Ops<T>::hasMinMax && useAvx2(n)
+               ? Avx2::template extreme<true>(data, n)
+               : Scalar::min(data, n);
+  }
+
+  static T max(const T* data, size_t n) {
+    return useAvx512(n) ? Avx512::template extreme<false>(data, n)
+           : Avx2Ops<T>::hasMinMax && useAvx2(n)
+               ? Avx2::template extreme<false>(data, n)
+               : Scalar::max(data, n);
+  }
+
+  static T sum(const T* data, size_t n) {
+    return useAvx512(n)  ? Avx512::sum(data, n)
+           : useAvx2(n) ? Avx2::sum(data, n)
+                        : Scalar::sum(data, n);
+  }
+};
+
+#else
+
+template <typename T>
+struct SimdKernels : ScalarKernels<T> {};
+
+#endif
+
+#endif
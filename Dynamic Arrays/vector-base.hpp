@@ -0,0 +1,335 @@
+#ifndef VECTOR_BASE_H
+#define VECTOR_BASE_H
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "../Utility/trivially-relocatable.hpp"
+#include "growth-policy.hpp"
+#include "simd-kernels.hpp"
+
+// The part of Vector and SmallVector that does not depend on where the
+// elements live. Derived owns the buffer: its constructors set data and
+// m_capacity, and releaseBuffer() frees the current buffer once its
+// elements have been moved out or destroyed. Any new buffer comes from the
+// allocator
+template <typename Derived, typename T, typename Allocator,
+          typename GrowthPolicy>
+class VectorBase {
+ protected:
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+ public:
+  // Accessors
+  bool empty() const { return size() == 0; }
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_capacity; }
+  Allocator get_allocator() const { return allocator; }
+
+  T& operator[](size_t index) const { return data[index]; }
+
+  // Modifiers
+
+  // Only the live elements are moved; the spare slots stay uninitialized.
+  // Trivially relocatable elements are moved with a single memcpy
+  void reserve(size_t newCapacity) {
+    if (newCapacity <= m_capacity) return;
+
+    T* newArray = allocate(newCapacity);
+    relocate_elements(allocator, data, m_size, newArray);
+    replaceBuffer(newArray, newCapacity);
+  }
+
+  void resize(size_t newSize) {
+    reserve(newSize);
+    while (m_size < newSize) {
+      AllocTraits::construct(allocator, data + m_size);
+      ++m_size;
+    }
+    while (m_size > newSize) {
+      pop_back();
+    }
+  }
+
+  void resize(size_t newSize, const T& value) {
+    reserve(newSize);
+    while (m_size < newSize) {
+      AllocTraits::construct(allocator, data + m_size, value);
+      ++m_size;
+    }
+    while (m_size > newSize) {
+      pop_back();
+    }
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    if (m_size == m_capacity) {
+      return growAndEmplace(std::forward<Args>(args)...);
+    }
+    AllocTraits::construct(allocator, data + m_size,
+                           std::forward<Args>(args)...);
+    return data[m_size++];
+  }
+
+  void push_back(const T& newValue) { emplace_back(newValue); }
+
+  void push_back(T&& newValue) { emplace_back(std::move(newValue)); }
+
+  void pop_back() { AllocTraits::destroy(allocator, data + --m_size); }
+
+  T& front() const { return data[0]; };
+  T& back() const { return data[m_size - 1]; }
+
+  void clear() {
+    while (m_size > 0) {
+      pop_back();
+    }
+  }
+
+  // Insert before place; the elements after it are shifted once
+  void insert(const T& value, size_t place) { emplace(place, value); }
+
+  void insert(T&& value, size_t place) { emplace(place, std::move(value)); }
+
+  template <typename... Args>
+  T& emplace(size_t place, Args&&... args) {
+    if (place == m_size) {
+      return emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Build the value first, args may refer to an element that gets shifted
+    T value(std::forward<Args>(args)...);
+    reserveFor(1);
+    shiftTail(place, 1);
+    data[place] = std::move(value);
+    ++m_size;
+    return data[place];
+  }
+
+  // Insert [first, last) before place, growing the buffer at most once. The
+  // range must not point into this vector
+  template <typename InputIt>
+  void insert(size_t place, InputIt first, InputIt last) {
+    insertRange(place, first, last,
+                typename std::iterator_traits<InputIt>::iterator_category());
+  }
+
+  template <typename InputIt>
+  void append_range(InputIt first, InputIt last) {
+    insert(m_size, first, last);
+  }
+
+  // Remove the element at place
+  void remove(size_t place) { erase(place, place + 1); }
+
+  // Remove the elements in [first, last); the tail is shifted once
+  void erase(size_t first, size_t last) {
+    if (first >= last) return;
+
+    std::move(data + last, data + m_size, data + first);
+    size_t removed = last - first;
+    for (size_t i = 0; i < removed; i++) {
+      pop_back();
+    }
+  }
+
+  // Remove every element matching pred in a single pass and return how many
+  // were removed
+  template <typename Predicate>
+  size_t erase_if(Predicate pred) {
+    T* newEnd = std::remove_if(data, data + m_size, pred);
+    size_t removed = static_cast<size_t>(data + m_size - newEnd);
+    for (size_t i = 0; i < removed; i++) {
+      pop_back();
+    }
+    return removed;
+  }
+
+  // Search and aggregation. Arithmetic element types run vectorized kernels
+  // when the CPU supports them (see simd-kernels.hpp)
+
+  static const size_t npos = static_cast<size_t>(-1);
+
+  // Index of the first element equal to value, or npos
+  size_t find(const T& value) const {
+    size_t index = SimdKernels<T>::find(data, m_size, value);
+    return index < m_size ? index : npos;
+  }
+
+  bool contains(const T& value) const { return find(value) != npos; }
+
+  size_t count(const T& value) const {
+    return SimdKernels<T>::count(data, m_size, value);
+  }
+
+  T min() const {
+    if (empty()) {
+      throw std::out_of_range("can not take min of an empty vector");
+    }
+    return SimdKernels<T>::min(data, m_size);
+  }
+
+  T max() const {
+    if (empty()) {
+      throw std::out_of_range("can not take max of an empty vector");
+    }
+    return SimdKernels<T>::max(data, m_size);
+  }
+
+  // Sum of the elements, accumulated in T
+  T sum() const { return SimdKernels<T>::sum(data, m_size); }
+
+  // Iterators
+  T* begin() { return data; }
+  T* end() { return data + m_size; }
+  const T* begin() const { return data; }
+  const T* end() const { return data + m_size; }
+
+ protected:
+  size_t m_size;
+  size_t m_capacity;
+  T* data;
+  Allocator allocator;
+
+  VectorBase(T* storage, size_t capacity, const Allocator& alloc)
+      : m_size{0}, m_capacity{capacity}, data{storage}, allocator{alloc} {}
+
+  // Copying and moving are up to Derived, which knows the buffer
+  VectorBase(const VectorBase&) = delete;
+  VectorBase& operator=(const VectorBase&) = delete;
+  ~VectorBase() = default;
+
+  T* allocate(size_t count) { return AllocTraits::allocate(allocator, count); }
+
+  void deallocate(T* array, size_t count) {
+    AllocTraits::deallocate(allocator, array, count);
+  }
+
+  // Free the current buffer, whose elements have been moved out, and use
+  // newArray instead
+  void replaceBuffer(T* newArray, size_t newCapacity) {
+    static_cast<Derived*>(this)->releaseBuffer();
+    data = newArray;
+    m_capacity = newCapacity;
+  }
+
+  // Copy the elements of rhs after the current ones. Expects room for them;
+  // if a copy throws, every element and the buffer are freed
+  void copyElements(const VectorBase& rhs) {
+    try {
+      for (size_t i = 0; i < rhs.m_size; i++) {
+        AllocTraits::construct(allocator, data + m_size, rhs.data[i]);
+        ++m_size;
+      }
+    } catch (...) {
+      clear();
+      static_cast<Derived*>(this)->releaseBuffer();
+      throw;
+    }
+  }
+
+ private:
+  void reserveFor(size_t count) {
+    if (m_size + count > m_capacity) {
+      reserve(GrowthPolicy::grow(m_capacity, m_size + count, sizeof(T)));
+    }
+  }
+
+  // Move [place, m_size) up by count slots, constructing the slots past the
+  // old end and assigning the rest. Needs room for count more elements;
+  // leaves m_size unchanged and [place, place + count) moved-from or raw
+  void shiftTail(size_t place, size_t count) {
+    for (size_t i = m_size; i-- > place;) {
+      size_t to = i + count;
+      if (to >= m_size) {
+        AllocTraits::construct(allocator, data + to, std::move(data[i]));
+      } else {
+        data[to] = std::move(data[i]);
+      }
+    }
+  }
+
+  template <typename ForwardIt>
+  void insertRange(size_t place, ForwardIt first, ForwardIt last,
+                   std::forward_iterator_tag) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count == 0) return;
+
+    if (m_size + count > m_capacity) {
+      // Build the new buffer in one pass: the inserted range straight into
+      // its final slots, then the old prefix and suffix around it
+      size_t newCapacity =
+          GrowthPolicy::grow(m_capacity, m_size + count, sizeof(T));
+      T* newArray = allocate(newCapacity);
+
+      size_t built = 0;
+      try {
+        for (; built < count; ++built, ++first) {
+          AllocTraits::construct(allocator, newArray + place + built, *first);
+        }
+      } catch (...) {
+        for (size_t i = 0; i < built; ++i) {
+          AllocTraits::destroy(allocator, newArray + place + i);
+        }
+        deallocate(newArray, newCapacity);
+        throw;
+      }
+      relocate_elements(allocator, data, place, newArray);
+      relocate_elements(allocator, data + place, m_size - place,
+                        newArray + place + count);
+      replaceBuffer(newArray, newCapacity);
+      m_size += count;
+      return;
+    }
+
+    shiftTail(place, count);
+    for (size_t i = place; i < place + count; ++i, ++first) {
+      if (i < m_size) {
+        data[i] = *first;
+      } else {
+        AllocTraits::construct(allocator, data + i, *first);
+      }
+    }
+    m_size += count;
+  }
+
+  // Single-pass ranges cannot be measured up front: append, then rotate the
+  // new elements into place
+  template <typename InputIt>
+  void insertRange(size_t place, InputIt first, InputIt last,
+                   std::input_iterator_tag) {
+    size_t oldSize = m_size;
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+    std::rotate(data + place, data + oldSize, data + m_size);
+  }
+
+  // The new element is constructed before the old ones are moved, so args
+  // may refer to an element of this vector
+  template <typename... Args>
+  T& growAndEmplace(Args&&... args) {
+    size_t newCapacity =
+        GrowthPolicy::grow(m_capacity, m_size + 1, sizeof(T));
+    T* newArray = allocate(newCapacity);
+
+    try {
+      AllocTraits::construct(allocator, newArray + m_size,
+                             std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(newArray, newCapacity);
+      throw;
+    }
+    relocate_elements(allocator, data, m_size, newArray);
+    replaceBuffer(newArray, newCapacity);
+    return data[m_size++];
+  }
+};
+
+#endif
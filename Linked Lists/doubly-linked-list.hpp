@@ -4,20 +4,85 @@
 #include <stdlib.h>
 
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class List {
  private:
   struct Node {
     Node* next;
     Node* prev;
     T data;
-    Node(const T& d = T{}, Node* p = nullptr, Node* n = nullptr)
-        : data{d}, prev{p}, next{n} {}
+
+    // The element is constructed in place from args
+    template <typename... Args>
+    Node(Node* p, Node* n, Args&&... args)
+        : next{n}, prev{p}, data(std::forward<Args>(args)...) {}
+  };
+
+  using NodeAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  // Bidirectional iterator; Value is T or const T. The end iterator keeps
+  // the list so it can step back to the tail
+  template <typename Value>
+  class Iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    Iterator(Node* n = nullptr, const List* l = nullptr) : node{n}, list{l} {}
+
+    // iterator converts to const_iterator
+    operator Iterator<const T>() const { return Iterator<const T>(node, list); }
+
+    Value& operator*() const { return node->data; }
+    Value* operator->() const { return &node->data; }
+
+    Iterator& operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator old = *this;
+      node = node->next;
+      return old;
+    }
+
+    Iterator& operator--() {
+      node = node != nullptr ? node->prev : list->tail;
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      Iterator old = *this;
+      --*this;
+      return old;
+    }
+
+    bool operator==(const Iterator& rhs) const { return node == rhs.node; }
+    bool operator!=(const Iterator& rhs) const { return node != rhs.node; }
+
+   private:
+    Node* node;
+    const List* list;
+    friend class List;
   };
 
  public:
-  List() : m_size{0}, head{nullptr}, tail{nullptr} {}
+  using iterator = Iterator<T>;
+  using const_iterator = Iterator<const T>;
+
+  explicit List(const Allocator& alloc = Allocator())
+      : m_size{0}, head{nullptr}, tail{nullptr}, node_allocator{alloc} {}
 
   ~List() { clear(); }
 
@@ -30,8 +95,18 @@ class List {
     }
   }
 
-  void push_front(const T& item) {
-    Node* newNode = new Node(item, nullptr, head);
+  iterator begin() { return iterator(head, this); }
+  iterator end() { return iterator(nullptr, this); }
+  const_iterator begin() const { return const_iterator(head, this); }
+  const_iterator end() const { return const_iterator(nullptr, this); }
+
+  void push_front(const T& item) { emplace_front(item); }
+
+  void push_front(T&& item) { emplace_front(std::move(item)); }
+
+  template <typename... Args>
+  T& emplace_front(Args&&... args) {
+    Node* newNode = createNode(nullptr, head, std::forward<Args>(args)...);
 
     if (head != nullptr) {
       head->prev = newNode;
@@ -42,18 +117,81 @@ class List {
 
     head = newNode;
     ++m_size;
+    return newNode->data;
   }
 
-  void push_back(const T& item) {
+  void push_back(const T& item) { emplace_back(item); }
+
+  void push_back(T&& item) { emplace_back(std::move(item)); }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
     if (empty()) {
-      push_front(item);
-      return;
+      return emplace_front(std::forward<Args>(args)...);
     }
 
-    Node* newNode = new Node(item, tail, nullptr);
+    Node* newNode = createNode(tail, nullptr, std::forward<Args>(args)...);
     tail->next = newNode;
     tail = newNode;
     ++m_size;
+    return newNode->data;
+  }
+
+  // Insert before pos (end() appends) and return an iterator to the new
+  // element
+  iterator insert(const_iterator pos, const T& item) {
+    return emplace(pos, item);
+  }
+
+  iterator insert(const_iterator pos, T&& item) {
+    return emplace(pos, std::move(item));
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    Node* next = pos.node;
+    if (next == nullptr) {
+      emplace_back(std::forward<Args>(args)...);
+      return iterator(tail, this);
+    }
+    if (next == head) {
+      emplace_front(std::forward<Args>(args)...);
+      return iterator(head, this);
+    }
+
+    Node* newNode =
+        createNode(next->prev, next, std::forward<Args>(args)...);
+    next->prev->next = newNode;
+    next->prev = newNode;
+    ++m_size;
+    return iterator(newNode, this);
+  }
+
+  // Insert right after pos and return an iterator to the new element
+  iterator insert_after(const_iterator pos, const T& item) {
+    return emplace(std::next(pos), item);
+  }
+
+  iterator insert_after(const_iterator pos, T&& item) {
+    return emplace(std::next(pos), std::move(item));
+  }
+
+  // Remove the element at pos and return an iterator to the one after it
+  iterator erase(const_iterator pos) {
+    Node* victim = pos.node;
+    Node* next = victim->next;
+
+    if (victim == head) {
+      pop_front();
+    } else if (victim == tail) {
+      pop_back();
+    } else {
+      victim->prev->next = next;
+      next->prev = victim->prev;
+      destroyNode(victim);
+      --m_size;
+    }
+    return iterator(next, this);
   }
 
   void pop_front() {
@@ -69,7 +207,7 @@ class List {
       tail = nullptr;
     }
 
-    delete temp;
+    destroyNode(temp);
     --m_size;
   }
 
@@ -86,20 +224,25 @@ class List {
       tail->next = nullptr;
     }
 
-    delete temp;
+    destroyNode(temp);
     --m_size;
   }
 
-  void insertAt(const T& item, size_t pos) {
+  void insertAt(const T& item, size_t pos) { emplaceAt(pos, item); }
+
+  void insertAt(T&& item, size_t pos) { emplaceAt(pos, std::move(item)); }
+
+  template <typename... Args>
+  void emplaceAt(size_t pos, Args&&... args) {
     // Special case for inserting at the front
     if (pos == 0 || empty()) {
-      push_front(item);
+      emplace_front(std::forward<Args>(args)...);
       return;
     }
 
     // If position is beyond the list size, insert at the end
     if (pos >= m_size) {
-      push_back(item);
+      emplace_back(std::forward<Args>(args)...);
       return;
     }
 
@@ -122,14 +265,15 @@ class List {
     }
 
     // Insert the new node between current and current->next
-    Node* newNode = new Node(item, current, current->next);
+    Node* newNode =
+        createNode(current, current->next, std::forward<Args>(args)...);
     current->next->prev = newNode;
     current->next = newNode;
     ++m_size;
   }
 
-  friend std::ostream& operator<<(std::ostream& out, const List<T>& list) {
-    typename List<T>::Node* current = list.head;
+  friend std::ostream& operator<<(std::ostream& out, const List& list) {
+    Node* current = list.head;
     while (current) {
       out << current->data;
       if (current->next) out << " -> ";
@@ -172,6 +316,24 @@ class List {
   size_t m_size;
   Node* head;
   Node* tail;
+  NodeAllocator node_allocator;
+
+  template <typename... Args>
+  Node* createNode(Args&&... args) {
+    Node* node = NodeTraits::allocate(node_allocator, 1);
+    try {
+      NodeTraits::construct(node_allocator, node, std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(node_allocator, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroyNode(Node* node) {
+    NodeTraits::destroy(node_allocator, node);
+    NodeTraits::deallocate(node_allocator, node, 1);
+  }
 };
 
 #endif
\ No newline at end of file
@@ -4,18 +4,71 @@
 #include <stdlib.h>
 
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class List {
  private:
   struct Node {
     Node* next;
     T data;
-    Node(const T& d = T{}, Node* n = nullptr) : data{d}, next{n} {}
+
+    // The element is constructed in place from args
+    template <typename... Args>
+    Node(Node* n, Args&&... args)
+        : next{n}, data(std::forward<Args>(args)...) {}
+  };
+
+  using NodeAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  // Forward iterator; Value is T or const T
+  template <typename Value>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    Iterator(Node* n = nullptr) : node{n} {}
+
+    // iterator converts to const_iterator
+    operator Iterator<const T>() const { return Iterator<const T>(node); }
+
+    Value& operator*() const { return node->data; }
+    Value* operator->() const { return &node->data; }
+
+    Iterator& operator++() {
+      node = node->next;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator old = *this;
+      node = node->next;
+      return old;
+    }
+
+    bool operator==(const Iterator& rhs) const { return node == rhs.node; }
+    bool operator!=(const Iterator& rhs) const { return node != rhs.node; }
+
+   private:
+    Node* node;
+    friend class List;
   };
 
  public:
-  List() : m_size{0}, head{nullptr} {}
+  using iterator = Iterator<T>;
+  using const_iterator = Iterator<const T>;
+
+  explicit List(const Allocator& alloc = Allocator())
+      : m_size{0}, head{nullptr}, tail{nullptr}, node_allocator{alloc} {}
 
   ~List() { clear(); }
 
@@ -28,31 +81,113 @@ class List {
     }
   }
 
-  void push_front(const T& item) {
-    head = new Node(item, head);
+  iterator begin() { return iterator(head); }
+  iterator end() { return iterator(); }
+  const_iterator begin() const { return const_iterator(head); }
+  const_iterator end() const { return const_iterator(); }
+
+  void push_front(const T& item) { emplace_front(item); }
+
+  void push_front(T&& item) { emplace_front(std::move(item)); }
+
+  template <typename... Args>
+  T& emplace_front(Args&&... args) {
+    head = createNode(head, std::forward<Args>(args)...);
+    if (tail == nullptr) {
+      tail = head;
+    }
     ++m_size;
+    return head->data;
   }
 
-  void push_back(const T& item) {
+  void push_back(const T& item) { emplace_back(item); }
+
+  void push_back(T&& item) { emplace_back(std::move(item)); }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
     if (empty()) {
-      push_front(item);
-      return;
+      return emplace_front(std::forward<Args>(args)...);
     }
 
-    Node* temp = head;
-    while (temp->next) {
-      temp = temp->next;
+    tail->next = createNode(nullptr, std::forward<Args>(args)...);
+    tail = tail->next;
+    ++m_size;
+    return tail->data;
+  }
+
+  // Insert right after pos and return an iterator to the new element
+  iterator insert_after(const_iterator pos, const T& item) {
+    return emplace_after(pos, item);
+  }
+
+  iterator insert_after(const_iterator pos, T&& item) {
+    return emplace_after(pos, std::move(item));
+  }
+
+  template <typename... Args>
+  iterator emplace_after(const_iterator pos, Args&&... args) {
+    Node* prev = pos.node;
+    prev->next = createNode(prev->next, std::forward<Args>(args)...);
+    if (prev == tail) {
+      tail = prev->next;
     }
-    temp->next = new Node(item);
     ++m_size;
+    return iterator(prev->next);
   }
 
+  // Remove the element after pos and return an iterator to the one that
+  // followed it. The first element is removed with pop_front
+  iterator erase_after(const_iterator pos) {
+    Node* prev = pos.node;
+    Node* victim = prev->next;
+    prev->next = victim->next;
+    if (victim == tail) {
+      tail = prev;
+    }
+    destroyNode(victim);
+    --m_size;
+    return iterator(prev->next);
+  }
+
+  // Move every node of other to the end of this list in O(1), leaving other
+  // empty. Lists whose allocators differ fall back to moving the elements
+  void splice(List& other) {
+    if (this == &other || other.empty()) return;
+
+    if (!NodeTraits::is_always_equal::value &&
+        !(node_allocator == other.node_allocator)) {
+      for (Node* current = other.head; current; current = current->next) {
+        push_back(std::move(current->data));
+      }
+      other.clear();
+      return;
+    }
+
+    if (empty()) {
+      head = other.head;
+    } else {
+      tail->next = other.head;
+    }
+    tail = other.tail;
+    m_size += other.m_size;
+
+    other.head = nullptr;
+    other.tail = nullptr;
+    other.m_size = 0;
+  }
+
+  void append(List&& other) { splice(other); }
+
   void pop_front() {
     if (empty()) return;
 
     Node* temp = head;
     head = head->next;
-    delete temp;
+    if (head == nullptr) {
+      tail = nullptr;
+    }
+    destroyNode(temp);
     --m_size;
   }
 
@@ -61,8 +196,8 @@ class List {
 
     // If only one element
     if (head->next == nullptr) {
-      delete head;
-      head = nullptr;
+      destroyNode(head);
+      head = tail = nullptr;
       --m_size;
       return;
     }
@@ -74,8 +209,9 @@ class List {
     }
 
     // Delete the last node and update pointers
-    delete temp->next;
+    destroyNode(temp->next);
     temp->next = nullptr;
+    tail = temp;
     --m_size;
   }
 
@@ -99,21 +235,29 @@ class List {
 
     if (current != nullptr) {
       prev->next = current->next;
-      delete current;
+      if (current == tail) {
+        tail = prev;
+      }
+      destroyNode(current);
       --m_size;
     }
   }
 
-  void insertAt(const T& item, size_t pos) {
+  void insertAt(const T& item, size_t pos) { emplaceAt(pos, item); }
+
+  void insertAt(T&& item, size_t pos) { emplaceAt(pos, std::move(item)); }
+
+  template <typename... Args>
+  void emplaceAt(size_t pos, Args&&... args) {
     // Special case for inserting at the front
     if (pos == 0 || empty()) {
-      push_front(item);
+      emplace_front(std::forward<Args>(args)...);
       return;
     }
 
     // If position is beyond the list size, insert at the end
     if (pos >= m_size) {
-      push_back(item);
+      emplace_back(std::forward<Args>(args)...);
       return;
     }
 
@@ -126,13 +270,14 @@ class List {
     }
 
     if (current != nullptr) {
-      current->next = new Node(item, current->next);
+      current->next =
+          createNode(current->next, std::forward<Args>(args)...);
       ++m_size;
     }
   }
 
-  friend std::ostream& operator<<(std::ostream& out, const List<T>& list) {
-    typename List<T>::Node* current = list.head;
+  friend std::ostream& operator<<(std::ostream& out, const List& list) {
+    Node* current = list.head;
     while (current) {
       out << current->data;
       if (current->next) out << " -> ";
@@ -174,6 +319,25 @@ class List {
  private:
   size_t m_size;
   Node* head;
+  Node* tail;
+  NodeAllocator node_allocator;
+
+  template <typename... Args>
+  Node* createNode(Args&&... args) {
+    Node* node = NodeTraits::allocate(node_allocator, 1);
+    try {
+      NodeTraits::construct(node_allocator, node, std::forward<Args>(args)...);
+    } catch (...) {
+      NodeTraits::deallocate(node_allocator, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroyNode(Node* node) {
+    NodeTraits::destroy(node_allocator, node);
+    NodeTraits::deallocate(node_allocator, node, 1);
+  }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,435 @@
+#ifndef UNROLLED_LINKED_LIST
+#define UNROLLED_LINKED_LIST
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "../Utility/trivially-relocatable.hpp"
+
+// Doubly linked list of small arrays. Each node holds up to NODE_CAPACITY
+// elements in a block of about NodeBytes, so a scan touches one node per
+// several elements and indexing skips whole nodes at a time, while inserting
+// in the middle only shifts the elements of one node.
+template <typename T, size_t NodeBytes = 256,
+          typename Allocator = std::allocator<T>>
+class UnrolledList {
+ private:
+  static const size_t HEADER_BYTES = 2 * sizeof(void*) + sizeof(size_t);
+
+ public:
+  static const size_t NODE_CAPACITY =
+      NodeBytes > HEADER_BYTES + sizeof(T)
+          ? (NodeBytes - HEADER_BYTES) / sizeof(T)
+          : 1;
+
+ private:
+  struct Node {
+    Node* next;
+    Node* prev;
+    size_t count;
+    alignas(T) unsigned char storage[NODE_CAPACITY * sizeof(T)];
+
+    Node(Node* p = nullptr, Node* n = nullptr) : next{n}, prev{p}, count{0} {}
+
+    T* items() { return reinterpret_cast<T*>(storage); }
+    bool full() const { return count == NODE_CAPACITY; }
+  };
+
+  using NodeAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    iterator(Node* n = nullptr, size_t o = 0) : node{n}, offset{o} {}
+
+    T& operator*() const { return node->items()[offset]; }
+    T* operator->() const { return node->items() + offset; }
+
+    iterator& operator++() {
+      if (++offset == node->count) {
+        node = node->next;
+        offset = 0;
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const iterator& rhs) const {
+      return node == rhs.node && offset == rhs.offset;
+    }
+    bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+
+   private:
+    Node* node;
+    size_t offset;
+  };
+
+  explicit UnrolledList(const Allocator& alloc = Allocator())
+      : m_size{0}, head{nullptr}, tail{nullptr}, node_allocator{alloc} {}
+
+  UnrolledList(const UnrolledList& other)
+      : m_size{0},
+        head{nullptr},
+        tail{nullptr},
+        node_allocator{NodeTraits::select_on_container_copy_construction(
+            other.node_allocator)} {
+    try {
+      for (Node* node = other.head; node; node = node->next) {
+        for (size_t i = 0; i < node->count; i++) {
+          push_back(node->items()[i]);
+        }
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  UnrolledList(UnrolledList&& other)
+      : m_size{other.m_size},
+        head{other.head},
+        tail{other.tail},
+        node_allocator{std::move(other.node_allocator)} {
+    other.m_size = 0;
+    other.head = other.tail = nullptr;
+  }
+
+  UnrolledList& operator=(const UnrolledList& other) {
+    if (this != &other) {
+      UnrolledList temp(other);
+      swap(temp);
+    }
+    return *this;
+  }
+
+  UnrolledList& operator=(UnrolledList&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~UnrolledList() { clear(); }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return size() == 0; }
+
+  iterator begin() { return iterator(head, 0); }
+  iterator end() { return iterator(); }
+
+  void clear() {
+    while (head != nullptr) {
+      Node* next = head->next;
+      destroyItems(head);
+      destroyNode(head);
+      head = next;
+    }
+    tail = nullptr;
+    m_size = 0;
+  }
+
+  void push_front(const T& item) {
+    if (head == nullptr || head->full()) {
+      linkNode(filledNode(item), nullptr, head);
+      return;
+    }
+    insertIntoNode(head, 0, item);
+  }
+
+  void push_back(const T& item) {
+    if (tail == nullptr || tail->full()) {
+      linkNode(filledNode(item), tail, nullptr);
+      return;
+    }
+    insertIntoNode(tail, tail->count, item);
+  }
+
+  void pop_front() {
+    if (empty()) return;
+    eraseFromNode(head, 0);
+  }
+
+  void pop_back() {
+    if (empty()) return;
+    eraseFromNode(tail, tail->count - 1);
+  }
+
+  // Remove the first element equal to item
+  void remove(const T& item) {
+    for (Node* node = head; node; node = node->next) {
+      for (size_t i = 0; i < node->count; i++) {
+        if (node->items()[i] == item) {
+          eraseFromNode(node, i);
+          return;
+        }
+      }
+    }
+  }
+
+  void insertAt(const T& item, size_t pos) {
+    // Special case for inserting at the front
+    if (pos == 0 || empty()) {
+      push_front(item);
+      return;
+    }
+
+    // If position is beyond the list size, insert at the end
+    if (pos >= m_size) {
+      push_back(item);
+      return;
+    }
+
+    size_t offset;
+    Node* node = locate(pos, offset);
+
+    if (!node->full()) {
+      insertIntoNode(node, offset, item);
+      return;
+    }
+
+    // A full node is split in two so the insertion only shifts half a node
+    size_t keep = node->count / 2;
+    Node* right = splitNode(node, keep);
+    if (offset > keep) {
+      node = right;
+      offset -= keep;
+    }
+
+    // With one element per node a half can be empty; don't leave it linked
+    try {
+      insertIntoNode(node, offset, item);
+    } catch (...) {
+      if (node->count == 0) {
+        unlinkNode(node);
+      }
+      throw;
+    }
+  }
+
+  friend std::ostream& operator<<(std::ostream& out,
+                                  const UnrolledList& list) {
+    for (Node* node = list.head; node; node = node->next) {
+      for (size_t i = 0; i < node->count; i++) {
+        out << node->items()[i];
+        if (i + 1 < node->count || node->next) out << " -> ";
+      }
+    }
+    return out;
+  }
+
+  T& operator[](size_t index) {
+    if (index >= size()) {
+      throw std::out_of_range("Out of bounds");
+    }
+
+    size_t offset;
+    Node* node = locate(index, offset);
+    return node->items()[offset];
+  }
+
+  T operator[](size_t index) const {
+    if (index >= size()) {
+      throw std::out_of_range("Out of bounds");
+    }
+
+    size_t offset;
+    Node* node = locate(index, offset);
+    return node->items()[offset];
+  }
+
+ private:
+  size_t m_size;
+  Node* head;
+  Node* tail;
+  NodeAllocator node_allocator;
+
+  void swap(UnrolledList& other) {
+    std::swap(m_size, other.m_size);
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(node_allocator, other.node_allocator);
+  }
+
+  // Find the node holding element index, walking node by node from the
+  // nearer end
+  Node* locate(size_t index, size_t& offset) const {
+    if (index < m_size / 2) {
+      Node* node = head;
+      while (index >= node->count) {
+        index -= node->count;
+        node = node->next;
+      }
+      offset = index;
+      return node;
+    }
+
+    size_t remaining = m_size - 1 - index;
+    Node* node = tail;
+    while (remaining >= node->count) {
+      remaining -= node->count;
+      node = node->prev;
+    }
+    offset = node->count - 1 - remaining;
+    return node;
+  }
+
+  Node* newNode() {
+    Node* node = NodeTraits::allocate(node_allocator, 1);
+    NodeTraits::construct(node_allocator, node);
+    return node;
+  }
+
+  // A new unlinked node holding a copy of item, freed again if the copy
+  // throws
+  Node* filledNode(const T& item) {
+    Node* node = newNode();
+    try {
+      insertIntoNode(node, 0, item);
+    } catch (...) {
+      destroyNode(node);
+      throw;
+    }
+    return node;
+  }
+
+  // Move the elements of node from keep on into a new node linked after it.
+  // The new node is only linked once they are all in place, so a throwing
+  // move leaves node whole
+  Node* splitNode(Node* node, size_t keep) {
+    Node* right = newNode();
+    T* from = node->items() + keep;
+    size_t count = node->count - keep;
+
+    if (is_trivially_relocatable<T>::value) {
+      relocate_elements(from, count, right->items());
+    } else {
+      try {
+        for (; right->count < count; right->count++) {
+          ::new (static_cast<void*>(right->items() + right->count))
+              T(std::move(from[right->count]));
+        }
+      } catch (...) {
+        destroyItems(right);
+        destroyNode(right);
+        throw;
+      }
+      for (size_t i = 0; i < count; i++) {
+        from[i].~T();
+      }
+    }
+
+    right->count = count;
+    node->count = keep;
+    linkNode(right, node, node->next);
+    return right;
+  }
+
+  // Link node in between prev and next
+  void linkNode(Node* node, Node* prev, Node* next) {
+    node->prev = prev;
+    node->next = next;
+
+    if (prev != nullptr) {
+      prev->next = node;
+    } else {
+      head = node;
+    }
+    if (next != nullptr) {
+      next->prev = node;
+    } else {
+      tail = node;
+    }
+  }
+
+  void unlinkNode(Node* node) {
+    if (node->prev != nullptr) {
+      node->prev->next = node->next;
+    } else {
+      head = node->next;
+    }
+    if (node->next != nullptr) {
+      node->next->prev = node->prev;
+    } else {
+      tail = node->prev;
+    }
+    destroyNode(node);
+  }
+
+  void destroyNode(Node* node) {
+    NodeTraits::destroy(node_allocator, node);
+    NodeTraits::deallocate(node_allocator, node, 1);
+  }
+
+  static void destroyItems(Node* node) {
+    for (size_t i = 0; i < node->count; i++) {
+      node->items()[i].~T();
+    }
+    node->count = 0;
+  }
+
+  // Expects node to have a free slot
+  void insertIntoNode(Node* node, size_t offset, const T& item) {
+    T* items = node->items();
+
+    if (offset == node->count) {
+      ::new (static_cast<void*>(items + offset)) T(item);
+    } else {
+      T copy(item);
+      ::new (static_cast<void*>(items + node->count))
+          T(std::move(items[node->count - 1]));
+      for (size_t i = node->count - 1; i > offset; i--) {
+        items[i] = std::move(items[i - 1]);
+      }
+      items[offset] = std::move(copy);
+    }
+
+    ++node->count;
+    ++m_size;
+  }
+
+  // Remove one element, then drop the node if it became empty, or fold the
+  // next node into it when the two together fill at most half a node
+  void eraseFromNode(Node* node, size_t offset) {
+    T* items = node->items();
+    for (size_t i = offset; i + 1 < node->count; i++) {
+      items[i] = std::move(items[i + 1]);
+    }
+    items[--node->count].~T();
+    --m_size;
+
+    if (node->count == 0) {
+      unlinkNode(node);
+      return;
+    }
+
+    Node* next = node->next;
+    if (next != nullptr && node->count + next->count <= NODE_CAPACITY / 2) {
+      relocate_elements(next->items(), next->count, items + node->count);
+      node->count += next->count;
+      next->count = 0;
+      unlinkNode(next);
+    }
+  }
+};
+
+#endif
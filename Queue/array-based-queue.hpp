@@ -1,55 +1,91 @@
 #ifndef ARRAY_QUEUE_H
 #define ARRAY_QUEUE_H
 
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <utility>
 
-template <typename T>
+#include "../Utility/capacity-policy.hpp"
+#include "../Utility/ring-buffer-utils.hpp"
+#include "../Utility/trivially-relocatable.hpp"
+
+// Circular buffer queue. The capacity is always a power of two, and head and
+// tail are running counts of dequeued and enqueued elements: the size is
+// tail - head and a position maps to its slot with a mask, so enqueue and
+// dequeue need neither a division nor an empty/non-empty branch.
+//
+// The buffer doubles when full. ShrinkPolicy (see capacity-policy.hpp)
+// decides when dequeue gives memory back; the default halves the buffer
+// once it is less than a quarter full.
+template <typename T, typename ShrinkPolicy = ShrinkAtQuarter>
 class Queue {
  public:
-  explicit Queue(size_t intial_capacity = 10)
-      : front_index{0}, rear_index{0}, capacity{intial_capacity}, m_size{0} {
-    array = new T[capacity];
+  // A contiguous run of queued elements
+  template <typename U>
+  struct basic_span {
+    U* data;
+    size_t size;
+
+    U* begin() const { return data; }
+    U* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+  };
+
+  using span = basic_span<T>;
+  using const_span = basic_span<const T>;
+
+  explicit Queue(size_t intial_capacity = 10,
+                 const ShrinkPolicy& policy = ShrinkPolicy())
+      : head{0},
+        tail{0},
+        m_capacity{intial_capacity > 0 ? next_power_of_two(intial_capacity)
+                                     : 0},
+        shrink_policy{policy} {
+    array = allocate(m_capacity);
   }
 
-  ~Queue() { delete[] array; }
+  ~Queue() {
+    clear();
+    deallocate(array, m_capacity);
+  }
 
   // Copy Constructor
   Queue(const Queue& other)
-      : front_index{other.front_index},
-        rear_index{other.rear_index},
-        capacity{other.capacity},
-        m_size{other.m_size} {
-    array = new T[capacity];
+      : head{0},
+        tail{0},
+        m_capacity{other.m_capacity},
+        shrink_policy{other.shrink_policy} {
+    array = allocate(m_capacity);
 
-    for (size_t i = 0; i < m_size; i++) {
-      array[i] = other.array[i];
+    // The copy is laid out from slot 0 regardless of where other wraps
+    for (size_t i = other.head; i != other.tail; i++) {
+      ::new (static_cast<void*>(array + tail)) T(other.array[other.slot(i)]);
+      tail++;
     }
   }
 
   // Move Constructor
   Queue(Queue&& other)
-      : front_index{other.front_index},
-        rear_index{other.rear_index},
-        capacity{other.capacity},
-        m_size{other.m_size} {
+      : array{other.array},
+        head{other.head},
+        tail{other.tail},
+        m_capacity{other.m_capacity},
+        shrink_policy{std::move(other.shrink_policy)} {
     other.array = nullptr;
-    other.front_index = 0;
-    other.rear_index = 0;
-    other.capacity = 0;
-    other.m_size = 0;
+    other.head = 0;
+    other.tail = 0;
+    other.m_capacity = 0;
   }
 
   // Copy assignment operator
   Queue& operator=(const Queue& other) {
     if (this != &other) {
       Queue temp(other);
-      std::swap(array, temp.array);
-      std::swap(front_index, temp.front_index);
-      std::swap(rear_index, temp.rear_index);
-      std::swap(capacity, temp.capacity);
-      std::swap(m_size, temp.m_size);
+      swap(temp);
     }
     return *this;
   }
@@ -57,18 +93,11 @@ class Queue {
   // Move assignment operator
   Queue& operator=(Queue&& other) {
     if (this != &other) {
-      delete[] array;
-      array = other.array;
-      front_index = other.front_index;
-      rear_index = other.rear_index;
-      capacity = other.capacity;
-      m_size = other.m_size;
-
-      other.array = nullptr;
-      other.front_index = 0;
-      other.rear_index = 0;
-      other.capacity = 0;
-      other.m_size = 0;
+      clear();
+      deallocate(array, m_capacity);
+      array = nullptr;
+      m_capacity = 0;
+      swap(other);
     }
     return *this;
   }
@@ -76,97 +105,252 @@ class Queue {
   // enqueue
   void enqueue(const T& item) {
     if (full()) {
-      resize(capacity * 2);
-    }
-
-    if (!empty()) {
-      rear_index = (rear_index + 1) % capacity;
+      // item may live in the buffer that is about to be released
+      T copy(item);
+      resize(grown_capacity());
+      construct_rear(std::move(copy));
+      return;
     }
 
-    array[rear_index] = item;
-    m_size++;
+    construct_rear(item);
   }
 
   // enqueue with move semantics
   void enqueue(T&& item) {
     if (full()) {
-      resize(capacity * 2);
+      T temp(std::move(item));
+      resize(grown_capacity());
+      construct_rear(std::move(temp));
+      return;
     }
 
-    if (!empty()) {
-      rear_index = (rear_index + 1) % capacity;
-    }
-
-    array[rear_index] = std::move(item);
-    m_size++;
+    construct_rear(std::move(item));
   }
 
-  // dequeue
-  void dequeue() {
+  // dequeue, handing back the removed element
+  T dequeue() {
     if (empty()) {
       throw std::out_of_range("can not dequeue from empty queue");
     }
-    if (!empty()) {
-      front_index = (front_index + 1) % capacity;
-    }
 
-    // shrink the array if it's too large
-    if (m_size > 0 && m_size < capacity / 4) {
-      resize(capacity / 2);
+    T* front_slot = array + slot(head);
+    T item(std::move(*front_slot));
+    front_slot->~T();
+    head++;
+
+    maybe_shrink();
+    return item;
+  }
+
+  // Enqueue [first, last), growing the buffer at most once. The range must
+  // not point into this queue
+  template <typename InputIt>
+  void enqueue_bulk(InputIt first, InputIt last) {
+    enqueueRange(first, last,
+                 typename std::iterator_traits<InputIt>::iterator_category());
+  }
+
+  // Move up to max elements from the front to out, in order, and return how
+  // many were moved. Trivially copyable elements moved to a pointer are
+  // copied in at most two memmoves
+  template <typename OutputIt>
+  size_t dequeue_bulk(OutputIt out, size_t max) {
+    size_t count = max < size() ? max : size();
+
+    std::pair<span, span> runs = spans(array, count);
+    out = std::move(runs.first.begin(), runs.first.end(), out);
+    std::move(runs.second.begin(), runs.second.end(), out);
+
+    discard(count);
+    return count;
+  }
+
+  // The queued elements as at most two contiguous runs, front first: the
+  // second run is empty unless the elements wrap around the buffer. They
+  // can be read, or handed to I/O, in place; discard() then drops them.
+  // Any enqueue or dequeue invalidates the spans
+  std::pair<span, span> peek_spans() { return spans(array, size()); }
+
+  std::pair<const_span, const_span> peek_spans() const {
+    return spans<const T>(array, size());
+  }
+
+  // Remove the first count elements without returning them
+  void discard(size_t count) {
+    if (count > size()) {
+      throw std::out_of_range("can not discard more elements than queued");
     }
 
-    m_size--;
+    for (size_t end = head + count; head != end; head++) {
+      array[slot(head)].~T();
+    }
+    maybe_shrink();
   }
 
   T& front() {
     if (empty()) {
       throw std::out_of_range("can not dequeue from empty queue");
     }
-    return array[front_index];
+    return array[slot(head)];
   }
 
   const T& front() const {
     if (empty()) {
       throw std::out_of_range("can not dequeue from empty queue");
     }
-    return array[front_index];
+    return array[slot(head)];
+  }
+
+  size_t size() const { return tail - head; }
+
+  size_t capacity() const { return m_capacity; }
+
+  // Bytes of heap memory held for elements, used or not
+  size_t memory_usage() const { return m_capacity * sizeof(T); }
+
+  // Make room for at least new_capacity elements (rounded up to a power of
+  // two) without reallocating
+  void reserve(size_t new_capacity) {
+    if (new_capacity > m_capacity) {
+      resize(next_power_of_two(new_capacity));
+    }
   }
 
-  size_t size() const { return m_size; }
+  // Shrink the buffer to the smallest power of two holding the elements.
+  // With NeverShrink this is the only way the queue gives memory back
+  void shrink_to_fit() {
+    size_t target = size() > 0 ? next_power_of_two(size()) : 0;
+    if (target < m_capacity) {
+      resize(target);
+    }
+  }
 
   bool empty() const { return size() == 0; }
 
   void clear() {
-    delete[] array;
+    for (; head != tail; head++) {
+      array[slot(head)].~T();
+    }
 
-    front_index = 0;
-    rear_index = 0;
-    capacity = 0;
-    m_size = 0;
+    head = 0;
+    tail = 0;
   }
 
  private:
   T* array;
-  size_t front_index;
-  size_t rear_index;
-  size_t capacity;
-  size_t m_size;
+  size_t head;  // Elements dequeued so far
+  size_t tail;  // Elements enqueued so far
+  size_t m_capacity;
+  ShrinkPolicy shrink_policy;
+
+  static T* allocate(size_t count) {
+    return count > 0 ? std::allocator<T>().allocate(count) : nullptr;
+  }
+
+  static void deallocate(T* buffer, size_t count) {
+    if (buffer != nullptr) {
+      std::allocator<T>().deallocate(buffer, count);
+    }
+  }
+
+  void swap(Queue& other) {
+    std::swap(array, other.array);
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(shrink_policy, other.shrink_policy);
+  }
+
+  // Capacity is a power of two, so the mask is a modulo
+  size_t slot(size_t position) const { return position & (m_capacity - 1); }
+
+  size_t grown_capacity() const {
+    return m_capacity > 0 ? m_capacity * 2 : 1;
+  }
+
+  // The first count elements as two runs, the second empty unless they
+  // wrap. base is the buffer, seen as T or const T
+  template <typename U>
+  std::pair<basic_span<U>, basic_span<U>> spans(U* base, size_t count) const {
+    if (count == 0) {
+      return {{base, 0}, {base, 0}};
+    }
+
+    size_t first = slot(head);
+    size_t first_run =
+        m_capacity - first < count ? m_capacity - first : count;
+    return {{base + first, first_run}, {base, count - first_run}};
+  }
+
+  template <typename ForwardIt>
+  void enqueueRange(ForwardIt first, ForwardIt last,
+                    std::forward_iterator_tag) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (size() + count > m_capacity) {
+      resize(next_power_of_two(size() + count));
+    }
+
+    // The free slots also form at most two runs, starting at the rear
+    size_t rear = slot(tail);
+    size_t first_run = m_capacity - rear < count ? m_capacity - rear : count;
+    ForwardIt middle = std::next(first, first_run);
+    // Count each run in as soon as it is built, so a throwing copy leaves
+    // every constructed element queued and none leaked
+    std::uninitialized_copy(first, middle, array + rear);
+    tail += first_run;
+    std::uninitialized_copy(middle, last, array);
+    tail += count - first_run;
+  }
+
+  template <typename InputIt>
+  void enqueueRange(InputIt first, InputIt last, std::input_iterator_tag) {
+    for (; first != last; ++first) {
+      enqueue(*first);
+    }
+  }
+
+  template <typename U>
+  void construct_rear(U&& item) {
+    ::new (static_cast<void*>(array + slot(tail))) T(std::forward<U>(item));
+    tail++;
+  }
 
   void resize(size_t new_capacity) {
-    T* new_array = new T[new_capacity];
+    T* new_array = allocate(new_capacity);
+    size_t count = size();
 
-    for (size_t i = 0; i < m_size; i++) {
-      size_t index = (i + front_index) % capacity;
-      new_array[i] = std::move(array[index]);
+    // The live elements occupy at most two contiguous runs of the ring, each
+    // relocated in one go (a memcpy when T allows it)
+    if (count > 0) {
+      size_t first = slot(head);
+      size_t first_run = m_capacity - first;
+      if (first_run > count) {
+        first_run = count;
+      }
+      relocate_elements(array + first, first_run, new_array);
+      relocate_elements(array, count - first_run, new_array + first_run);
     }
 
-    delete[] array;
+    deallocate(array, m_capacity);
     array = new_array;
-    rear_index = m_size > 0 ? m_size - 1 : 0;
-    capacity = new_capacity;
+    head = 0;
+    tail = count;
+    m_capacity = new_capacity;
   }
 
-  bool full() const { return m_size == capacity; }
+  bool full() const { return size() == m_capacity; }
+
+  // Policies may ask for any smaller size; the buffer stays a power of two
+  // that holds every element
+  void maybe_shrink() {
+    size_t target = shrink_policy.shrinkTo(size(), m_capacity);
+    if (target < m_capacity) {
+      target = next_power_of_two(target > size() ? target : size());
+      if (target < m_capacity) {
+        resize(target);
+      }
+    }
+  }
 };
 
 #endif
@@ -0,0 +1,290 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <optional>
+#define CONCURRENT_QUEUE_COROUTINES 1
+#endif
+#endif
+
+#include "../Utility/ring-buffer-utils.hpp"
+
+// Unbounded queue for any number of producer and consumer threads, after
+// Michael and Scott's two-lock queue. The list always starts with a dummy
+// node. Producers only take tail_lock to link a node after the last one,
+// and consumers only take head_lock to advance the dummy, so the two sides
+// never wait on each other.
+//
+// Nodes are recycled instead of freed. A consumer pushes the dummy it
+// retires onto a lock-free free list. A producer, when its private spare
+// list runs out, takes the whole free list in one exchange. Taking every
+// node at once avoids the ABA problem of popping one node. Once the queue
+// has reached its peak size, enqueue and dequeue no longer allocate.
+//
+// Consumers can poll with try_dequeue, block with wait_dequeue (optionally
+// with a timeout), or, when compiled as C++20, co_await pop(). A producer
+// only touches head_lock when some consumer is waiting.
+template <typename T>
+class ConcurrentQueue {
+ private:
+  struct Node {
+    std::atomic<Node*> next;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    Node() : next{nullptr} {}
+
+    T* item() { return reinterpret_cast<T*>(storage); }
+  };
+
+ public:
+  ConcurrentQueue()
+      : head{new Node()}, dequeued{0}, waiting{0}, spare{nullptr},
+        enqueued{0}, freed{nullptr} {
+    tail = head;
+  }
+
+  ConcurrentQueue(const ConcurrentQueue&) = delete;
+  ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+  // Not thread-safe: no other thread may use the queue any more, and no
+  // coroutine may still be suspended in pop()
+  ~ConcurrentQueue() {
+    Node* node = head->next.load(std::memory_order_relaxed);
+    delete head;
+    while (node != nullptr) {
+      Node* next = node->next.load(std::memory_order_relaxed);
+      node->item()->~T();
+      delete node;
+      node = next;
+    }
+    freeList(spare);
+    freeList(freed.load(std::memory_order_relaxed));
+  }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    {
+      std::lock_guard<std::mutex> lock(tail_lock);
+      Node* node = takeNode();
+      try {
+        ::new (static_cast<void*>(node->item()))
+            T(std::forward<Args>(args)...);
+      } catch (...) {
+        node->next.store(spare, std::memory_order_relaxed);
+        spare = node;
+        throw;
+      }
+      node->next.store(nullptr, std::memory_order_relaxed);
+
+      // Publishes the element to consumers; pairs with the seq_cst
+      // increment of waiting in a consumer about to sleep
+      tail->next.store(node, std::memory_order_seq_cst);
+      tail = node;
+      enqueued.store(enqueued.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+    }
+
+    if (waiting.load(std::memory_order_seq_cst) != 0) {
+      wakeConsumer();
+    }
+  }
+
+  void enqueue(const T& item) { emplace(item); }
+  void enqueue(T&& item) { emplace(std::move(item)); }
+
+  // Returns false, without blocking, if the queue is empty
+  bool try_dequeue(T& item) {
+    std::lock_guard<std::mutex> lock(head_lock);
+    return popFront(item);
+  }
+
+  // Blocks until an element is available
+  void wait_dequeue(T& item) {
+    std::unique_lock<std::mutex> lock(head_lock);
+    if (popFront(item)) {
+      return;
+    }
+
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+    not_empty.wait(lock, [&] { return popFront(item); });
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Blocks for at most timeout. Returns false if no element arrived
+  template <typename Rep, typename Period>
+  bool wait_dequeue(T& item,
+                    const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(head_lock);
+    if (popFront(item)) {
+      return true;
+    }
+
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+    bool found =
+        not_empty.wait_for(lock, timeout, [&] { return popFront(item); });
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+    return found;
+  }
+
+  // A snapshot; other threads may change it right away
+  size_t size() const {
+    size_t consumed = dequeued.load(std::memory_order_relaxed);
+    size_t produced = enqueued.load(std::memory_order_relaxed);
+    return produced > consumed ? produced - consumed : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+#ifdef CONCURRENT_QUEUE_COROUTINES
+  class PopAwaiter {
+   public:
+    explicit PopAwaiter(ConcurrentQueue& q) : queue{q} {}
+
+    bool await_ready() {
+      std::lock_guard<std::mutex> lock(queue.head_lock);
+      return queue.popFront(result);
+    }
+
+    // Registers as waiting before checking once more, so a producer either
+    // sees the registration or its element is found here
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> lock(queue.head_lock);
+      queue.waiting.fetch_add(1, std::memory_order_seq_cst);
+      if (queue.popFront(result)) {
+        queue.waiting.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      coroutine = handle;
+      queue.awaiters.push_back(this);
+      return true;
+    }
+
+    T await_resume() { return std::move(*result); }
+
+   private:
+    friend class ConcurrentQueue;
+
+    ConcurrentQueue& queue;
+    std::optional<T> result;
+    std::coroutine_handle<> coroutine;
+  };
+
+  // co_await queue.pop() yields the front element, suspending the
+  // coroutine while the queue is empty. A suspended coroutine is resumed on
+  // the thread of the producer that hands it an element, after that
+  // producer has released every lock. T must be move constructible
+  PopAwaiter pop() { return PopAwaiter(*this); }
+#endif
+
+ private:
+  // Consumer's line
+  alignas(CACHE_LINE_SIZE) std::mutex head_lock;
+  Node* head;  // The dummy; its successor holds the front element
+  std::atomic<size_t> dequeued;
+  std::atomic<size_t> waiting;  // Blocked threads plus suspended coroutines
+  std::condition_variable not_empty;
+#ifdef CONCURRENT_QUEUE_COROUTINES
+  std::deque<PopAwaiter*> awaiters;
+#endif
+
+  // Producer's line
+  alignas(CACHE_LINE_SIZE) std::mutex tail_lock;
+  Node* tail;
+  Node* spare;  // Recycled nodes owned by the producers
+  std::atomic<size_t> enqueued;
+
+  // Retired dummies pushed by consumers, taken in bulk by producers
+  alignas(CACHE_LINE_SIZE) std::atomic<Node*> freed;
+
+  static void freeList(Node* node) {
+    while (node != nullptr) {
+      Node* next = node->next.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  // Called with tail_lock held
+  Node* takeNode() {
+    if (spare == nullptr) {
+      spare = freed.exchange(nullptr, std::memory_order_acquire);
+      if (spare == nullptr) {
+        return new Node();
+      }
+    }
+
+    Node* node = spare;
+    spare = node->next.load(std::memory_order_relaxed);
+    return node;
+  }
+
+  // Called with head_lock held, so only one consumer pushes at a time
+  void recycle(Node* node) {
+    Node* top = freed.load(std::memory_order_relaxed);
+    do {
+      node->next.store(top, std::memory_order_relaxed);
+    } while (!freed.compare_exchange_weak(top, node,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  // Called with head_lock held. Moves the front element into out (a T or
+  // std::optional<T>); its node becomes the new dummy. The seq_cst load
+  // pairs with the producers' publishing store
+  template <typename Output>
+  bool popFront(Output& out) {
+    Node* first = head->next.load(std::memory_order_seq_cst);
+    if (first == nullptr) {
+      return false;
+    }
+
+    out = std::move(*first->item());
+    first->item()->~T();
+
+    Node* old = head;
+    head = first;
+    dequeued.store(dequeued.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    recycle(old);
+    return true;
+  }
+
+  // Hand the front element to a suspended coroutine if there is one,
+  // otherwise wake a blocked thread. Taking head_lock orders this after a
+  // consumer that saw the queue empty has started waiting
+  void wakeConsumer() {
+#ifdef CONCURRENT_QUEUE_COROUTINES
+    PopAwaiter* awaiter = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(head_lock);
+      if (!awaiters.empty() && popFront(awaiters.front()->result)) {
+        awaiter = awaiters.front();
+        awaiters.pop_front();
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+    if (awaiter != nullptr) {
+      awaiter->coroutine.resume();
+      return;
+    }
+#else
+    { std::lock_guard<std::mutex> lock(head_lock); }
+#endif
+    not_empty.notify_one();
+  }
+};
+
+#endif
@@ -2,10 +2,11 @@
 #define LL_QUEUE_H
 
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class LL_Queue {
  private:
   struct Node {
@@ -16,21 +17,33 @@ class LL_Queue {
     Node(T&& value) : data(std::move(value)), next(nullptr) {}
   };
 
+  using NodeAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
  public:
   // Constructor
-  LL_Queue() : front_node{nullptr}, rear_node{nullptr}, m_size{0} {}
+  explicit LL_Queue(const Allocator& alloc = Allocator())
+      : front_node{nullptr},
+        rear_node{nullptr},
+        m_size{0},
+        node_allocator{alloc} {}
 
   ~LL_Queue() { clear(); }
 
   LL_Queue(const LL_Queue& other)
-      : front_node{nullptr}, rear_node{nullptr}, m_size{0} {
+      : front_node{nullptr},
+        rear_node{nullptr},
+        m_size{0},
+        node_allocator{NodeTraits::select_on_container_copy_construction(
+            other.node_allocator)} {
     if (other.empty()) {
       return;
     }
 
     Node* current = other.front_node;
     while (current) {
-      enqueue(current->data);
+      enqueu(current->data);
       current = current->next;
     }
   }
@@ -39,7 +52,8 @@ class LL_Queue {
   LL_Queue(LL_Queue&& other)
       : front_node{other.front_node},
         rear_node{other.rear_node},
-        m_size{other.m_size} {
+        m_size{other.m_size},
+        node_allocator{std::move(other.node_allocator)} {
     other.front_node = nullptr;
     other.rear_node = nullptr;
     other.m_size = 0;
@@ -49,9 +63,10 @@ class LL_Queue {
   LL_Queue& operator=(const LL_Queue& other) {
     if (this != &other) {
       LL_Queue temp(other);
-      std::swap(front_node, other.front_node);
-      std::swap(rear_node, other.rear_node);
-      std::swap(m_size, other.m_size);
+      std::swap(front_node, temp.front_node);
+      std::swap(rear_node, temp.rear_node);
+      std::swap(m_size, temp.m_size);
+      std::swap(node_allocator, temp.node_allocator);
     }
 
     return *this;
@@ -61,6 +76,7 @@ class LL_Queue {
   LL_Queue& operator=(LL_Queue&& other) {
     if (this != &other) {
       clear();
+      node_allocator = std::move(other.node_allocator);
       front_node = other.front_node;
       rear_node = other.rear_node;
       m_size = other.m_size;
@@ -75,7 +91,7 @@ class LL_Queue {
 
   // enqueue
   void enqueu(const T& item) {
-    Node* new_node = new T(item);
+    Node* new_node = createNode(item);
     if (empty()) {
       front_node = rear_node = new_node;
     } else {
@@ -88,7 +104,7 @@ class LL_Queue {
 
   // enqueue with move semantics
   void enqueu(T&& item) {
-    Node* new_node = new Node(std::move(item));
+    Node* new_node = createNode(std::move(item));
     if (empty()) {
       front_node = rear_node = new_node;
     } else {
@@ -113,7 +129,7 @@ class LL_Queue {
       rear_node = nullptr;
     }
 
-    delete temp;
+    destroyNode(temp);
     --m_size;
   }
 
@@ -147,6 +163,24 @@ class LL_Queue {
   Node* front_node;
   Node* rear_node;
   size_t m_size;
+  NodeAllocator node_allocator;
+
+  template <typename U>
+  Node* createNode(U&& value) {
+    Node* node = NodeTraits::allocate(node_allocator, 1);
+    try {
+      NodeTraits::construct(node_allocator, node, std::forward<U>(value));
+    } catch (...) {
+      NodeTraits::deallocate(node_allocator, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroyNode(Node* node) {
+    NodeTraits::destroy(node_allocator, node);
+    NodeTraits::deallocate(node_allocator, node, 1);
+  }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "../Utility/ring-buffer-utils.hpp"
+
+// Bounded lock-free queue for any number of producer and consumer threads,
+// after Dmitry Vyukov's bounded MPMC queue.
+//
+// Every slot carries a sequence number that says whose turn it is. For the
+// slot of running position p:
+//  - sequence == p means it is free for the producer that claims p
+//  - sequence == p + 1 means it holds an element for the consumer that
+//    claims p
+// A producer claims positions by advancing tail with a CAS, fills the slot
+// and publishes it by setting the sequence. A consumer claims positions by
+// advancing head, empties the slot, and hands it to the next lap by setting
+// the sequence to p + capacity. Producers and consumers touch different
+// counters, and each slot is only contended by the two threads whose turn
+// it is.
+//
+// The capacity is rounded up to a power of two (at least 2).
+template <typename T>
+class MPMCQueue {
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* item() { return reinterpret_cast<T*>(storage); }
+  };
+
+ public:
+  explicit MPMCQueue(size_t min_capacity)
+      : mask{next_power_of_two(min_capacity > 2 ? min_capacity : 2) - 1},
+        slots{new Slot[mask + 1]},
+        head{0},
+        tail{0} {
+    for (size_t i = 0; i <= mask; i++) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  ~MPMCQueue() {
+    size_t end = tail.load(std::memory_order_relaxed);
+    for (size_t i = head.load(std::memory_order_relaxed); i != end; i++) {
+      slots[i & mask].item()->~T();
+    }
+    delete[] slots;
+  }
+
+  size_t capacity() const { return mask + 1; }
+
+  // A snapshot; other threads may change it right away
+  size_t size() const {
+    size_t consumed = head.load(std::memory_order_acquire);
+    size_t produced = tail.load(std::memory_order_acquire);
+    return produced > consumed ? produced - consumed : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    if (claim(tail, position, 1, 0) == 0) {
+      return false;
+    }
+
+    Slot& slot = slots[position & mask];
+    ::new (static_cast<void*>(slot.item())) T(std::forward<Args>(args)...);
+    slot.sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_enqueue(const T& item) { return try_emplace(item); }
+  bool try_enqueue(T&& item) { return try_emplace(std::move(item)); }
+
+  // Enqueue up to count elements from first with a single claim on tail.
+  // Returns how many were enqueued
+  template <typename InputIt>
+  size_t try_enqueue_bulk(InputIt first, size_t count) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    count = claim(tail, position, count, 0);
+
+    for (size_t i = 0; i < count; i++, ++first) {
+      Slot& slot = slots[(position + i) & mask];
+      ::new (static_cast<void*>(slot.item())) T(*first);
+      slot.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    return count;
+  }
+
+  bool try_dequeue(T& item) {
+    size_t position = head.load(std::memory_order_relaxed);
+    if (claim(head, position, 1, 1) == 0) {
+      return false;
+    }
+
+    release(slots[position & mask], position, item);
+    return true;
+  }
+
+  // Dequeue up to max elements into out with a single claim on head.
+  // Returns how many were dequeued
+  template <typename OutputIt>
+  size_t try_dequeue_bulk(OutputIt out, size_t max) {
+    size_t position = head.load(std::memory_order_relaxed);
+    size_t count = claim(head, position, max, 1);
+
+    for (size_t i = 0; i < count; i++, ++out) {
+      release(slots[(position + i) & mask], position + i, *out);
+    }
+    return count;
+  }
+
+ private:
+  const size_t mask;
+  Slot* const slots;
+
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> head;
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;
+
+  // Claim up to wanted consecutive positions from counter, starting at
+  // position (updated to the first one claimed). A slot is ready when its
+  // sequence is its position plus ready_offset: 0 for producers, 1 for
+  // consumers. Only the leading run of ready slots is claimed, and once
+  // ready a slot stays so until its claimer uses it, so checking before the
+  // CAS is enough. Returns the number claimed, 0 when the queue is full
+  // (producers) or empty (consumers)
+  size_t claim(std::atomic<size_t>& counter, size_t& position, size_t wanted,
+               size_t ready_offset) {
+    if (wanted == 0) {
+      return 0;
+    }
+
+    while (true) {
+      size_t ready = 0;
+      intptr_t lag = 0;
+      while (ready < wanted && ready <= mask) {
+        size_t sequence = slots[(position + ready) & mask].sequence.load(
+            std::memory_order_acquire);
+        lag = static_cast<intptr_t>(sequence -
+                                    (position + ready + ready_offset));
+        if (lag != 0) {
+          break;
+        }
+        ++ready;
+      }
+
+      if (ready == 0) {
+        // Behind: the slot is still a lap back, so the queue is full (or
+        // empty). Ahead: another thread claimed position first
+        if (lag < 0) {
+          return 0;
+        }
+        position = counter.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      if (counter.compare_exchange_weak(position, position + ready,
+                                        std::memory_order_relaxed)) {
+        return ready;
+      }
+    }
+  }
+
+  // Move the element out and hand the slot to the producers of the next lap
+  template <typename OutputRef>
+  void release(Slot& slot, size_t position, OutputRef&& out) {
+    T* item = slot.item();
+    out = std::move(*item);
+    item->~T();
+    slot.sequence.store(position + mask + 1, std::memory_order_release);
+  }
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef SEGMENTED_QUEUE_H
+#define SEGMENTED_QUEUE_H
+
+#include <stdlib.h>
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "../Utility/block-cache.hpp"
+
+// Queue stored in a chain of fixed-size blocks, BlockBytes each, like a
+// std::deque used from both ends. enqueue fills the tail block and links a
+// new one when it is full; dequeue empties the head block and unlinks it.
+// Elements never move, so no operation copies the whole queue the way
+// Queue::resize does, and memory follows the size block by block.
+//
+// A steadily flowing queue keeps freeing blocks at the head and needing
+// them at the tail; the BlockCache hands the same few blocks around, so it
+// does not call malloc at all.
+template <typename T, size_t BlockBytes = 4096>
+class SegmentedQueue {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "over-aligned elements are not supported");
+
+  struct Block {
+    Block* next;  // The block behind, or null
+  };
+
+  static const size_t HEADER_BYTES =
+      (sizeof(Block) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+ public:
+  // Elements per block (at least one)
+  static const size_t BLOCK_CAPACITY =
+      BlockBytes > HEADER_BYTES + sizeof(T)
+          ? (BlockBytes - HEADER_BYTES) / sizeof(T)
+          : 1;
+
+  SegmentedQueue()
+      : head_block{nullptr},
+        tail_block{nullptr},
+        head_index{0},
+        tail_index{0},
+        m_size{0},
+        cache{HEADER_BYTES + BLOCK_CAPACITY * sizeof(T)} {}
+
+  ~SegmentedQueue() { clearBlocks(); }
+
+  // Copy Constructor
+  SegmentedQueue(const SegmentedQueue& other) : SegmentedQueue() {
+    size_t index = other.head_index;
+    for (const Block* b = other.head_block; b != nullptr; b = b->next) {
+      size_t end = b == other.tail_block ? other.tail_index : BLOCK_CAPACITY;
+      for (; index < end; index++) {
+        enqueue(elements(b)[index]);
+      }
+      index = 0;
+    }
+  }
+
+  // Move Constructor
+  SegmentedQueue(SegmentedQueue&& other)
+      : head_block{other.head_block},
+        tail_block{other.tail_block},
+        head_index{other.head_index},
+        tail_index{other.tail_index},
+        m_size{other.m_size},
+        cache{std::move(other.cache)} {
+    other.head_block = nullptr;
+    other.tail_block = nullptr;
+    other.head_index = 0;
+    other.tail_index = 0;
+    other.m_size = 0;
+  }
+
+  // Copy assignment operator
+  SegmentedQueue& operator=(const SegmentedQueue& other) {
+    if (this != &other) {
+      SegmentedQueue temp(other);
+      swap(temp);
+    }
+    return *this;
+  }
+
+  // Move assignment operator
+  SegmentedQueue& operator=(SegmentedQueue&& other) {
+    if (this != &other) {
+      SegmentedQueue temp(std::move(other));
+      swap(temp);
+    }
+    return *this;
+  }
+
+  // enqueue
+  void enqueue(const T& item) { construct_rear(item); }
+
+  // enqueue with move semantics
+  void enqueue(T&& item) { construct_rear(std::move(item)); }
+
+  // dequeue, handing back the removed element
+  T dequeue() {
+    if (empty()) {
+      throw std::out_of_range("can not dequeue from empty queue");
+    }
+
+    T* front_slot = elements(head_block) + head_index;
+    T item(std::move(*front_slot));
+    front_slot->~T();
+    ++head_index;
+    --m_size;
+
+    if (m_size == 0) {
+      // Keep the one block and start over at its beginning
+      head_index = 0;
+      tail_index = 0;
+    } else if (head_index == BLOCK_CAPACITY) {
+      Block* emptied = head_block;
+      head_block = emptied->next;
+      head_index = 0;
+      cache.release(emptied);
+    }
+    return item;
+  }
+
+  T& front() {
+    if (empty()) {
+      throw std::out_of_range("can not dequeue from empty queue");
+    }
+    return elements(head_block)[head_index];
+  }
+
+  const T& front() const {
+    if (empty()) {
+      throw std::out_of_range("can not dequeue from empty queue");
+    }
+    return elements(head_block)[head_index];
+  }
+
+  size_t size() const { return m_size; }
+
+  bool empty() const { return m_size == 0; }
+
+  void clear() {
+    clearBlocks();
+    head_block = nullptr;
+    tail_block = nullptr;
+    head_index = 0;
+    tail_index = 0;
+    m_size = 0;
+  }
+
+  // Return the cached spare blocks to the system
+  void shrink_to_fit() { cache.trim(); }
+
+ private:
+  Block* head_block;  // Holds the front element; null before first use
+  Block* tail_block;  // Where the next element goes
+  size_t head_index;  // Front element's slot in head_block
+  size_t tail_index;  // Next free slot in tail_block
+  size_t m_size;
+  BlockCache cache;
+
+  static T* elements(Block* block) {
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(block) +
+                                HEADER_BYTES);
+  }
+
+  static const T* elements(const Block* block) {
+    return reinterpret_cast<const T*>(
+        reinterpret_cast<const char*>(block) + HEADER_BYTES);
+  }
+
+  Block* newBlock() {
+    Block* block = ::new (cache.acquire()) Block;
+    block->next = nullptr;
+    return block;
+  }
+
+  template <typename U>
+  void construct_rear(U&& item) {
+    if (tail_block != nullptr && tail_index < BLOCK_CAPACITY) {
+      ::new (static_cast<void*>(elements(tail_block) + tail_index))
+          T(std::forward<U>(item));
+      ++tail_index;
+      ++m_size;
+      return;
+    }
+
+    // Fill the new block before linking it, so a throwing constructor
+    // leaves the queue as it was
+    Block* block = newBlock();
+    try {
+      ::new (static_cast<void*>(elements(block))) T(std::forward<U>(item));
+    } catch (...) {
+      cache.release(block);
+      throw;
+    }
+
+    if (tail_block == nullptr) {
+      head_block = block;
+    } else {
+      tail_block->next = block;
+    }
+    tail_block = block;
+    tail_index = 1;
+    ++m_size;
+  }
+
+  // Destroy every element and release every block
+  void clearBlocks() {
+    size_t index = head_index;
+    while (head_block != nullptr) {
+      Block* block = head_block;
+      size_t end = block == tail_block ? tail_index : BLOCK_CAPACITY;
+      for (; index < end; index++) {
+        elements(block)[index].~T();
+      }
+      index = 0;
+
+      head_block = block->next;
+      cache.release(block);
+    }
+  }
+
+  void swap(SegmentedQueue& other) {
+    std::swap(head_block, other.head_block);
+    std::swap(tail_block, other.tail_block);
+    std::swap(head_index, other.head_index);
+    std::swap(tail_index, other.tail_index);
+    std::swap(m_size, other.m_size);
+    cache.swap(other.cache);
+  }
+};
+
+#endif
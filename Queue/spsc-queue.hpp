@@ -0,0 +1,162 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "../Utility/ring-buffer-utils.hpp"
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Handing over an element costs a few uncontended atomic operations
+// instead of a mutex and condition variable round trip.
+//
+// head and tail are running counts of dequeued and enqueued elements, mapped
+// to slots with a mask (the capacity is rounded up to a power of two). Each
+// side owns one of them and keeps a cached copy of the other, on its own
+// cache line, so it only reads the other side's line when the ring looks
+// full or empty.
+//
+// The try_ operations never block and return false (or a short count) when
+// the queue is full or empty.
+template <typename T>
+class SPSCQueue {
+ public:
+  explicit SPSCQueue(size_t min_capacity)
+      : slots{std::allocator<T>().allocate(
+            next_power_of_two(min_capacity > 0 ? min_capacity : 1))},
+        mask{next_power_of_two(min_capacity > 0 ? min_capacity : 1) - 1},
+        head{0},
+        tail_cache{0},
+        tail{0},
+        head_cache{0} {}
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  ~SPSCQueue() {
+    size_t end = tail.load(std::memory_order_relaxed);
+    for (size_t i = head.load(std::memory_order_relaxed); i != end; i++) {
+      slots[i & mask].~T();
+    }
+    std::allocator<T>().deallocate(slots, mask + 1);
+  }
+
+  size_t capacity() const { return mask + 1; }
+
+  // A snapshot; the other side may change it right away
+  size_t size() const {
+    size_t consumed = head.load(std::memory_order_acquire);
+    return tail.load(std::memory_order_acquire) - consumed;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  // Producer side
+
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    if (freeSlots(position, 1) == 0) {
+      return false;
+    }
+
+    ::new (static_cast<void*>(slots + (position & mask)))
+        T(std::forward<Args>(args)...);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_enqueue(const T& item) { return try_emplace(item); }
+  bool try_enqueue(T&& item) { return try_emplace(std::move(item)); }
+
+  // Enqueue up to count elements from first, publishing them together.
+  // Returns how many were enqueued
+  template <typename InputIt>
+  size_t try_enqueue_bulk(InputIt first, size_t count) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    size_t available = freeSlots(position, count);
+    if (count > available) {
+      count = available;
+    }
+
+    for (size_t i = 0; i < count; i++, ++first) {
+      ::new (static_cast<void*>(slots + ((position + i) & mask))) T(*first);
+    }
+    tail.store(position + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer side
+
+  bool try_dequeue(T& item) {
+    size_t position = head.load(std::memory_order_relaxed);
+    if (readySlots(position, 1) == 0) {
+      return false;
+    }
+
+    T* slot = slots + (position & mask);
+    item = std::move(*slot);
+    slot->~T();
+    head.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Dequeue up to max elements into out, releasing their slots together.
+  // Returns how many were dequeued
+  template <typename OutputIt>
+  size_t try_dequeue_bulk(OutputIt out, size_t max) {
+    size_t position = head.load(std::memory_order_relaxed);
+    size_t count = readySlots(position, max);
+    if (count > max) {
+      count = max;
+    }
+
+    for (size_t i = 0; i < count; i++, ++out) {
+      T* slot = slots + ((position + i) & mask);
+      *out = std::move(*slot);
+      slot->~T();
+    }
+    head.store(position + count, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  // Read-only after construction
+  T* const slots;
+  const size_t mask;
+
+  // Consumer's line
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> head;
+  size_t tail_cache;
+
+  // Producer's line, padded to a full line by the class alignment
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;
+  size_t head_cache;
+
+  // Free slots from position, as seen by the producer. The consumer's head
+  // is only read when the cached value shows fewer than wanted
+  size_t freeSlots(size_t position, size_t wanted) {
+    size_t free = capacity() - (position - head_cache);
+    if (free < wanted) {
+      head_cache = head.load(std::memory_order_acquire);
+      free = capacity() - (position - head_cache);
+    }
+    return free;
+  }
+
+  // Filled slots from position, as seen by the consumer
+  size_t readySlots(size_t position, size_t wanted) {
+    size_t ready = tail_cache - position;
+    if (ready < wanted) {
+      tail_cache = tail.load(std::memory_order_acquire);
+      ready = tail_cache - position;
+    }
+    return ready;
+  }
+};
+
+#endif
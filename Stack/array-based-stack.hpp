@@ -3,35 +3,51 @@
 
 #include <stdlib.h>
 
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <utility>
 
-template <typename T>
+#include "../Utility/capacity-policy.hpp"
+#include "../Utility/trivially-relocatable.hpp"
+
+// The array doubles when full. ShrinkPolicy (see capacity-policy.hpp)
+// decides when pop gives memory back; the default halves the array once it
+// is less than a quarter full.
+template <typename T, typename ShrinkPolicy = ShrinkAtQuarter>
 class ArrayStack {
  public:
-  explicit ArrayStack(size_t initial_capacity = 10)
-      : capacity(initial_capacity), top_index(0) {
-    array = new T[capacity];
+  explicit ArrayStack(size_t initial_capacity = 10,
+                      const ShrinkPolicy& policy = ShrinkPolicy())
+      : m_capacity(initial_capacity), top_index(0), shrink_policy(policy) {
+    array = allocate(m_capacity);
   }
 
-  ~ArrayStack() { delete[] array; }
+  ~ArrayStack() {
+    clear();
+    deallocate(array, m_capacity);
+  }
 
   // Copy constructor
   ArrayStack(const ArrayStack& other)
-      : capacity(other.capacity), top_index(other.top_index) {
-    array = new T[capacity];
-    for (size_t i = 0; i < top_index; i++) {
-      array[i] = other.array[i];
+      : m_capacity(other.m_capacity),
+        top_index(0),
+        shrink_policy(other.shrink_policy) {
+    array = allocate(m_capacity);
+    for (size_t i = 0; i < other.top_index; i++) {
+      ::new (static_cast<void*>(array + i)) T(other.array[i]);
+      ++top_index;
     }
   }
 
   // Move constructor
   ArrayStack(ArrayStack&& other) noexcept
       : array(other.array),
-        capacity(other.capacity),
-        top_index(other.top_index) {
+        m_capacity(other.m_capacity),
+        top_index(other.top_index),
+        shrink_policy(std::move(other.shrink_policy)) {
     other.array = nullptr;
-    other.capacity = 0;
+    other.m_capacity = 0;
     other.top_index = 0;
   }
 
@@ -40,8 +56,9 @@ class ArrayStack {
     if (this != &other) {
       ArrayStack temp(other);
       std::swap(array, temp.array);
-      std::swap(capacity, temp.capacity);
+      std::swap(m_capacity, temp.m_capacity);
       std::swap(top_index, temp.top_index);
+      std::swap(shrink_policy, temp.shrink_policy);
     }
     return *this;
   }
@@ -49,32 +66,41 @@ class ArrayStack {
   // Move assignment operator
   ArrayStack& operator=(ArrayStack&& other) noexcept {
     if (this != &other) {
-      delete[] array;
+      clear();
+      deallocate(array, m_capacity);
       array = other.array;
-      capacity = other.capacity;
+      m_capacity = other.m_capacity;
       top_index = other.top_index;
+      shrink_policy = std::move(other.shrink_policy);
       other.array = nullptr;
-      other.capacity = 0;
+      other.m_capacity = 0;
       other.top_index = 0;
     }
     return *this;
   }
 
   void push(const T& value) {
-    if (top_index >= capacity) {
-      resize(capacity * 2);
+    if (top_index >= m_capacity) {
+      // value may live in the buffer that is about to be released
+      T copy(value);
+      resize(grown_capacity());
+      ::new (static_cast<void*>(array + top_index++)) T(std::move(copy));
+      return;
     }
 
-    array[top_index++] = value;
+    ::new (static_cast<void*>(array + top_index++)) T(value);
   }
 
   // Push with move semantics
   void push(T&& value) {
-    if (top_index >= capacity) {
-      resize(capacity * 2);
+    if (top_index >= m_capacity) {
+      T temp(std::move(value));
+      resize(grown_capacity());
+      ::new (static_cast<void*>(array + top_index++)) T(std::move(temp));
+      return;
     }
 
-    array[top_index++] = std::move(value);
+    ::new (static_cast<void*>(array + top_index++)) T(std::move(value));
   }
 
   void pop() {
@@ -82,12 +108,8 @@ class ArrayStack {
       throw std::out_of_range("Cannot pop from an empty stack");
     }
 
-    --top_index;
-
-    // Shrink the array if it's too large
-    if (top_index > 0 && top_index < capacity / 4) {
-      resize(capacity / 2);
-    }
+    array[--top_index].~T();
+    maybe_shrink();
   }
 
   T& top() {
@@ -108,26 +130,71 @@ class ArrayStack {
 
   size_t size() const { return top_index; }
 
-  void clear() { top_index = 0; }
+  size_t capacity() const { return m_capacity; }
+
+  // Bytes of heap memory held for elements, used or not
+  size_t memory_usage() const { return m_capacity * sizeof(T); }
+
+  // Make room for at least new_capacity elements without reallocating
+  void reserve(size_t new_capacity) {
+    if (new_capacity > m_capacity) {
+      resize(new_capacity);
+    }
+  }
+
+  // Release the unused part of the array. With NeverShrink this is the only
+  // way the stack gives memory back
+  void shrink_to_fit() {
+    if (top_index < m_capacity) {
+      resize(top_index);
+    }
+  }
+
+  void clear() {
+    while (top_index > 0) {
+      array[--top_index].~T();
+    }
+  }
 
  private:
   T* array;
-  size_t capacity;
+  size_t m_capacity;
   size_t top_index;
+  ShrinkPolicy shrink_policy;
+
+  static T* allocate(size_t count) {
+    return count > 0 ? std::allocator<T>().allocate(count) : nullptr;
+  }
+
+  static void deallocate(T* buffer, size_t count) {
+    if (buffer != nullptr) {
+      std::allocator<T>().deallocate(buffer, count);
+    }
+  }
+
+  size_t grown_capacity() const {
+    return m_capacity > 0 ? m_capacity * 2 : 1;
+  }
 
   // Resize the array when it's full
   void resize(size_t new_capacity) {
-    T* new_array = new T[new_capacity];
+    T* new_array = allocate(new_capacity);
 
-    // Copy elements to the new array
-    for (size_t i = 0; i < top_index; i++) {
-      new_array[i] = std::move(array[i]);
-    }
+    // Relocate elements to the new array (a memcpy when T allows it)
+    relocate_elements(array, top_index, new_array);
 
-    delete[] array;
+    deallocate(array, m_capacity);
     array = new_array;
-    capacity = new_capacity;
+    m_capacity = new_capacity;
+  }
+
+  // Policies may ask for any smaller size that still holds every element
+  void maybe_shrink() {
+    size_t target = shrink_policy.shrinkTo(top_index, m_capacity);
+    if (target < m_capacity) {
+      resize(target > top_index ? target : top_index);
+    }
   }
 };
 
-#endif
\ No newline at end of file
+#endif
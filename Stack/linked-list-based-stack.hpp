@@ -1,11 +1,13 @@
 #ifndef LL_STACK_H
 #define LL_STACK_H
 
-#include <stdexcpt.h>
+#include <stdlib.h>
 
+#include <memory>
+#include <stdexcept>
 #include <utility>
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class LL_Stack {
  private:
   struct Node {
@@ -15,16 +17,44 @@ class LL_Stack {
     Node(const T& value) : data(value), next(nullptr) {}
     Node(T&& value) : data(std::move(value)), next(nullptr) {}
   };
+
+  using NodeAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
   Node* top_node;
   size_t m_size;
+  NodeAllocator node_allocator;
+
+  template <typename U>
+  Node* createNode(U&& value) {
+    Node* node = NodeTraits::allocate(node_allocator, 1);
+    try {
+      NodeTraits::construct(node_allocator, node, std::forward<U>(value));
+    } catch (...) {
+      NodeTraits::deallocate(node_allocator, node, 1);
+      throw;
+    }
+    return node;
+  }
+
+  void destroyNode(Node* node) {
+    NodeTraits::destroy(node_allocator, node);
+    NodeTraits::deallocate(node_allocator, node, 1);
+  }
 
  public:
-  LL_Stack() : top_node{}, m_size{0} {}
+  explicit LL_Stack(const Allocator& alloc = Allocator())
+      : top_node{}, m_size{0}, node_allocator{alloc} {}
 
   ~LL_Stack() { clear(); }
 
   // Copy Constructor
-  LL_Stack(const LL_Stack& other) : top_node{nullptr}, m_size{0} {
+  LL_Stack(const LL_Stack& other)
+      : top_node{nullptr},
+        m_size{0},
+        node_allocator{NodeTraits::select_on_container_copy_construction(
+            other.node_allocator)} {
     if (other.empty()) {
       return;
     }
@@ -48,7 +78,10 @@ class LL_Stack {
   }
 
   // Move constructor
-  LL_Stack(LL_Stack&& other) : top_node(other.top_node), m_size(other.m_size) {
+  LL_Stack(LL_Stack&& other)
+      : top_node(other.top_node),
+        m_size(other.m_size),
+        node_allocator(std::move(other.node_allocator)) {
     other.top_node = nullptr;
     other.m_size = 0;
   }
@@ -59,6 +92,7 @@ class LL_Stack {
       LL_Stack temp(other);
       std::swap(top_node, temp.top_node);
       std::swap(m_size, temp.m_size);
+      std::swap(node_allocator, temp.node_allocator);
     }
     return *this;
   }
@@ -67,6 +101,7 @@ class LL_Stack {
   LL_Stack& operator=(LL_Stack&& other) {
     if (this != &other) {
       clear();
+      node_allocator = std::move(other.node_allocator);
       top_node = other.top_node;
       m_size = other.m_size;
       other.top_node = nullptr;
@@ -76,7 +111,7 @@ class LL_Stack {
   }
 
   void push(const T& item) {
-    Node* newNode = new T(item);
+    Node* newNode = createNode(item);
     newNode->next = top_node;
     top_node = newNode;
     ++m_size;
@@ -84,7 +119,7 @@ class LL_Stack {
 
   // push with move semantics
   void push(T&& item) {
-    Node* newNode = new Node(std::move(item));
+    Node* newNode = createNode(std::move(item));
     newNode->next = top_node;
     top_node = newNode;
     ++m_size;
@@ -93,7 +128,7 @@ class LL_Stack {
   void pop() {
     Node* temp = top_node;
     top_node = top_node->next;
-    delete temp;
+    destroyNode(temp);
     m_size--;
   }
 
@@ -0,0 +1,175 @@
+#ifndef LOCK_FREE_STACK_H
+#define LOCK_FREE_STACK_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <utility>
+
+#include "../Utility/epoch-reclamation.hpp"
+#include "../Utility/ring-buffer-utils.hpp"
+
+// Stack for any number of threads, after Treiber: push and pop swing the
+// top pointer with a CAS. Popped nodes are freed through EpochReclamation
+// and pop reads top->next inside a Guard, so a node cannot be freed while
+// another thread still reads it. That also rules out ABA: a node's address
+// cannot be reused, and reappear on top, while a pop still holds it.
+//
+// Under contention every thread fails CASes on the same top pointer. A
+// push or pop whose CAS fails tries elimination (Hendler, Shavit and
+// Yerushalmi) before retrying: a pusher offers its node in a random slot
+// of a small array and waits briefly, and a popper that finds an offer
+// takes it directly. An eliminated push/pop pair never touches top. Set
+// EliminationSlots to 0 for a plain Treiber stack.
+template <typename T, size_t EliminationSlots = 8>
+class LockFreeStack {
+ private:
+  struct Node {
+    T data;
+    Node* next;
+
+    template <typename... Args>
+    explicit Node(Args&&... args)
+        : data(std::forward<Args>(args)...), next(nullptr) {}
+  };
+
+  struct alignas(CACHE_LINE_SIZE) Slot {
+    std::atomic<Node*> offer{nullptr};
+  };
+
+  static const unsigned PUSH_WAIT_SPINS = 256;
+
+ public:
+  LockFreeStack() : top_node{nullptr} {}
+
+  LockFreeStack(const LockFreeStack&) = delete;
+  LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+  // Not thread-safe: no other thread may use the stack any more
+  ~LockFreeStack() {
+    Node* node = top_node.load(std::memory_order_relaxed);
+    while (node != nullptr) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    Node* node = new Node(std::forward<Args>(args)...);
+    node->next = top_node.load(std::memory_order_relaxed);
+    while (!top_node.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+      if (eliminatePush(node)) {
+        return;
+      }
+      node->next = top_node.load(std::memory_order_relaxed);
+    }
+  }
+
+  void push(const T& item) { emplace(item); }
+  void push(T&& item) { emplace(std::move(item)); }
+
+  // Returns false if the stack is empty
+  bool try_pop(T& item) {
+    EpochReclamation::Guard guard;
+
+    Node* node = top_node.load(std::memory_order_acquire);
+    while (node != nullptr) {
+      if (top_node.compare_exchange_weak(node, node->next,
+                                         std::memory_order_acquire,
+                                         std::memory_order_acquire)) {
+        item = std::move(node->data);
+        EpochReclamation::retire(node);
+        return true;
+      }
+
+      Node* offered = eliminatePop();
+      if (offered != nullptr) {
+        // Never published on top, so no other thread can reach it
+        item = std::move(offered->data);
+        delete offered;
+        return true;
+      }
+      node = top_node.load(std::memory_order_acquire);
+    }
+    return false;
+  }
+
+  // A snapshot; other threads may change it right away
+  bool empty() const {
+    return top_node.load(std::memory_order_relaxed) == nullptr;
+  }
+
+ private:
+  alignas(CACHE_LINE_SIZE) std::atomic<Node*> top_node;
+  static const size_t SLOT_COUNT =
+      EliminationSlots > 0 ? EliminationSlots : 1;
+  Slot slots[SLOT_COUNT];
+
+  // Marks a slot whose offer a popper has taken
+  static Node* taken() { return reinterpret_cast<Node*>(uintptr_t(1)); }
+
+  static size_t randomSlot() {
+    thread_local uint32_t seed =
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&seed) >> 4) | 1;
+    // xorshift32
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed % SLOT_COUNT;
+  }
+
+  // Offer node in a free slot and wait for a popper. Returns true if one
+  // took it; otherwise the offer is withdrawn and the push goes on
+  bool eliminatePush(Node* node) {
+    if (EliminationSlots == 0) {
+      return false;
+    }
+
+    std::atomic<Node*>& offer = slots[randomSlot()].offer;
+    Node* expected = nullptr;
+    if (!offer.compare_exchange_strong(expected, node,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+      return false;
+    }
+
+    for (unsigned spin = 0; spin < PUSH_WAIT_SPINS; spin++) {
+      if (offer.load(std::memory_order_relaxed) == taken()) {
+        break;
+      }
+    }
+
+    // Withdraw; failing means a popper took the node meanwhile
+    expected = node;
+    if (offer.compare_exchange_strong(expected, nullptr,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    offer.store(nullptr, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Take a node offered by a waiting pusher, or null if there is none
+  Node* eliminatePop() {
+    if (EliminationSlots == 0) {
+      return nullptr;
+    }
+
+    std::atomic<Node*>& offer = slots[randomSlot()].offer;
+    Node* node = offer.load(std::memory_order_acquire);
+    if (node == nullptr || node == taken() ||
+        !offer.compare_exchange_strong(node, taken(),
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return node;
+  }
+};
+
+#endif
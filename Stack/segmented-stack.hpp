@@ -0,0 +1,204 @@
+#ifndef SEGMENTED_STACK_H
+#define SEGMENTED_STACK_H
+
+#include <stdlib.h>
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../Utility/block-cache.hpp"
+
+// Stack stored in a chain of fixed-size blocks, BlockBytes each. Growing
+// links one more block on top and shrinking unlinks the empty top block,
+// so elements never move. Push and pop cost the same at ten elements and
+// at ten million; ArrayStack has to copy every element when it doubles or
+// halves. The price is a pointer chase every BLOCK_CAPACITY elements.
+//
+// Released blocks go to a BlockCache, so pushing and popping across a
+// block boundary reuses the same memory instead of calling malloc.
+template <typename T, size_t BlockBytes = 4096>
+class SegmentedStack {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "over-aligned elements are not supported");
+
+  struct Block {
+    Block* prev;  // The block below, or null
+  };
+
+  static const size_t HEADER_BYTES =
+      (sizeof(Block) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+ public:
+  // Elements per block (at least one)
+  static const size_t BLOCK_CAPACITY =
+      BlockBytes > HEADER_BYTES + sizeof(T)
+          ? (BlockBytes - HEADER_BYTES) / sizeof(T)
+          : 1;
+
+  SegmentedStack()
+      : top_block{nullptr},
+        top_count{0},
+        m_size{0},
+        cache{HEADER_BYTES + BLOCK_CAPACITY * sizeof(T)} {}
+
+  ~SegmentedStack() { clear(); }
+
+  // Copy constructor
+  SegmentedStack(const SegmentedStack& other) : SegmentedStack() {
+    // Blocks only link downwards; push from the bottom one up
+    std::vector<const Block*> chain;
+    for (const Block* b = other.top_block; b != nullptr; b = b->prev) {
+      chain.push_back(b);
+    }
+
+    for (size_t i = chain.size(); i-- > 0;) {
+      size_t count = i == 0 ? other.top_count : BLOCK_CAPACITY;
+      const T* items = elements(chain[i]);
+      for (size_t j = 0; j < count; j++) {
+        push(items[j]);
+      }
+    }
+  }
+
+  // Move constructor
+  SegmentedStack(SegmentedStack&& other)
+      : top_block{other.top_block},
+        top_count{other.top_count},
+        m_size{other.m_size},
+        cache{std::move(other.cache)} {
+    other.top_block = nullptr;
+    other.top_count = 0;
+    other.m_size = 0;
+  }
+
+  // Copy assignment operator
+  SegmentedStack& operator=(const SegmentedStack& other) {
+    if (this != &other) {
+      SegmentedStack temp(other);
+      swap(temp);
+    }
+    return *this;
+  }
+
+  // Move assignment operator
+  SegmentedStack& operator=(SegmentedStack&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  void push(const T& value) { construct_top(value); }
+
+  // Push with move semantics
+  void push(T&& value) { construct_top(std::move(value)); }
+
+  void pop() {
+    if (isEmpty()) {
+      throw std::out_of_range("Cannot pop from an empty stack");
+    }
+
+    elements(top_block)[--top_count].~T();
+    --m_size;
+
+    if (top_count == 0) {
+      Block* emptied = top_block;
+      top_block = emptied->prev;
+      top_count = top_block != nullptr ? BLOCK_CAPACITY : 0;
+      cache.release(emptied);
+    }
+  }
+
+  T& top() {
+    if (isEmpty()) {
+      throw std::out_of_range("can not access top of an empty stack");
+    }
+    return elements(top_block)[top_count - 1];
+  }
+
+  const T& top() const {
+    if (isEmpty()) {
+      throw std::out_of_range("can not access top of an empty stack");
+    }
+    return elements(top_block)[top_count - 1];
+  }
+
+  bool isEmpty() const { return m_size == 0; }
+
+  size_t size() const { return m_size; }
+
+  void clear() {
+    while (top_block != nullptr) {
+      T* items = elements(top_block);
+      while (top_count > 0) {
+        items[--top_count].~T();
+      }
+
+      Block* emptied = top_block;
+      top_block = emptied->prev;
+      top_count = BLOCK_CAPACITY;
+      cache.release(emptied);
+    }
+
+    top_count = 0;
+    m_size = 0;
+  }
+
+  // Return the cached spare blocks to the system
+  void shrink_to_fit() { cache.trim(); }
+
+ private:
+  Block* top_block;  // Holds the top element; null when empty
+  size_t top_count;  // Elements in top_block
+  size_t m_size;
+  BlockCache cache;
+
+  static T* elements(Block* block) {
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(block) +
+                                HEADER_BYTES);
+  }
+
+  static const T* elements(const Block* block) {
+    return reinterpret_cast<const T*>(
+        reinterpret_cast<const char*>(block) + HEADER_BYTES);
+  }
+
+  template <typename U>
+  void construct_top(U&& value) {
+    if (top_block != nullptr && top_count < BLOCK_CAPACITY) {
+      ::new (static_cast<void*>(elements(top_block) + top_count))
+          T(std::forward<U>(value));
+      ++top_count;
+      ++m_size;
+      return;
+    }
+
+    // Fill the new block before linking it, so a throwing constructor
+    // leaves the stack as it was
+    Block* block = ::new (cache.acquire()) Block;
+    try {
+      ::new (static_cast<void*>(elements(block))) T(std::forward<U>(value));
+    } catch (...) {
+      cache.release(block);
+      throw;
+    }
+
+    block->prev = top_block;
+    top_block = block;
+    top_count = 1;
+    ++m_size;
+  }
+
+  void swap(SegmentedStack& other) {
+    std::swap(top_block, other.top_block);
+    std::swap(top_count, other.top_count);
+    std::swap(m_size, other.m_size);
+    cache.swap(other.cache);
+  }
+};
+
+#endif
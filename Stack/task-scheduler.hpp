@@ -0,0 +1,267 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../Queue/concurrent-queue.hpp"
+#include "work-stealing-deque.hpp"
+
+// Fixed pool of worker threads running fork-join tasks.
+//
+// Each worker owns a WorkStealingDeque. A task spawned on a worker goes to
+// the bottom of that worker's deque and is usually run by the same worker
+// next, while its data is still in cache. An idle worker steals the oldest
+// task from a random victim. Tasks spawned from outside the pool go through
+// a shared ConcurrentQueue. Workers that find nothing to do spin briefly,
+// then sleep until new work is spawned.
+//
+// Work is spawned and joined through a TaskGroup:
+//
+//   TaskScheduler::TaskGroup group(scheduler);
+//   group.run([&] { left = fib(n - 1); });
+//   right = fib(n - 2);
+//   group.wait();
+//
+// wait() runs other tasks while the group's tasks are unfinished, so a
+// worker blocked on a join never leaves a core idle, and recursion deeper
+// than the pool size cannot deadlock.
+class TaskScheduler {
+  struct Task;
+
+ public:
+  // Tasks run through a group, and group.wait() returns once they have all
+  // finished. The first exception a task throws is rethrown by wait()
+  class TaskGroup {
+   public:
+    explicit TaskGroup(TaskScheduler& s)
+        : scheduler{s}, pending{0}, failed{false} {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Waits, discarding any exception
+    ~TaskGroup() { join(); }
+
+    template <typename F>
+    void run(F&& body) {
+      scheduler.spawn(std::unique_ptr<Task>(
+          new Task{std::function<void()>(std::forward<F>(body)), this}));
+    }
+
+    void wait() {
+      join();
+      if (failed.load(std::memory_order_relaxed)) {
+        failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(std::move(error));
+      }
+    }
+
+   private:
+    friend class TaskScheduler;
+
+    TaskScheduler& scheduler;
+    std::atomic<size_t> pending;
+    std::atomic<bool> failed;
+    std::exception_ptr error;  // Written by the task that set failed
+
+    void join() {
+      while (pending.load(std::memory_order_acquire) != 0) {
+        if (!scheduler.runOne()) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  };
+
+  explicit TaskScheduler(
+      unsigned threads = std::thread::hardware_concurrency())
+      : stopping{false}, queued{0}, sleepers{0} {
+    if (threads == 0) {
+      threads = 1;
+    }
+
+    for (unsigned i = 0; i < threads; i++) {
+      workers.emplace_back(new Worker(i));
+    }
+    for (unsigned i = 0; i < threads; i++) {
+      workers[i]->thread = std::thread([this, i] { workerLoop(i); });
+    }
+  }
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  // Every TaskGroup must have been waited on
+  ~TaskScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(idle_lock);
+      stopping.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_all();
+    for (std::unique_ptr<Worker>& worker : workers) {
+      worker->thread.join();
+    }
+  }
+
+  size_t threadCount() const { return workers.size(); }
+
+ private:
+  static const unsigned SPINS_BEFORE_SLEEP = 64;
+
+  struct Task {
+    std::function<void()> body;
+    TaskGroup* group;
+  };
+
+  struct Worker {
+    WorkStealingDeque<Task*> deque;
+    std::thread thread;
+    unsigned index;
+    uint64_t seed;  // For picking victims
+
+    explicit Worker(unsigned i)
+        : index{i}, seed{0x9E3779B97F4A7C15ull * (i + 1)} {}
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  ConcurrentQueue<Task*> injected;  // Spawned from outside the pool
+
+  std::atomic<bool> stopping;
+  std::atomic<size_t> queued;  // Spawned and not yet taken by anyone
+  std::atomic<unsigned> sleepers;
+  std::mutex idle_lock;
+  std::condition_variable wake;
+
+  // The worker the calling thread is, in whichever scheduler it belongs
+  // to, or null
+  static Worker*& currentWorker() {
+    thread_local Worker* worker = nullptr;
+    return worker;
+  }
+
+  Worker* localWorker() {
+    Worker* worker = currentWorker();
+    return worker != nullptr && worker->index < workers.size() &&
+                   workers[worker->index].get() == worker
+               ? worker
+               : nullptr;
+  }
+
+  // queued is raised before sleepers is read, and sleep() raises sleepers
+  // before reading queued, all seq_cst: either the spawner sees the sleeper
+  // and notifies it under idle_lock, or the sleeper sees the task counted.
+  // The group's pending count is raised before the task can run. If the
+  // push throws, the task was never published: both counts go back down
+  // and the task is freed
+  void spawn(std::unique_ptr<Task> task) {
+    std::atomic<size_t>& pending = task->group->pending;
+    pending.fetch_add(1, std::memory_order_relaxed);
+    queued.fetch_add(1, std::memory_order_seq_cst);
+    try {
+      Worker* worker = localWorker();
+      if (worker != nullptr) {
+        worker->deque.push(task.get());
+      } else {
+        injected.enqueue(task.get());
+      }
+    } catch (...) {
+      queued.fetch_sub(1, std::memory_order_relaxed);
+      pending.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+    task.release();
+
+    if (sleepers.load(std::memory_order_seq_cst) != 0) {
+      { std::lock_guard<std::mutex> lock(idle_lock); }
+      wake.notify_one();
+    }
+  }
+
+  static void execute(Task* task) {
+    TaskGroup* group = task->group;
+    try {
+      task->body();
+    } catch (...) {
+      if (!group->failed.exchange(true, std::memory_order_relaxed)) {
+        group->error = std::current_exception();
+      }
+    }
+    delete task;
+    group->pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  // Run one task from the local deque, a victim or the shared queue.
+  // Returns false if none was found
+  bool runOne() {
+    Worker* worker = localWorker();
+    Task* task = nullptr;
+    if ((worker != nullptr && worker->deque.pop(task)) ||
+        stealAny(worker, task) || injected.try_dequeue(task)) {
+      queued.fetch_sub(1, std::memory_order_relaxed);
+      execute(task);
+      return true;
+    }
+    return false;
+  }
+
+  bool stealAny(Worker* thief, Task*& task) {
+    size_t count = workers.size();
+    size_t start = 0;
+    if (thief != nullptr) {
+      // xorshift64
+      thief->seed ^= thief->seed << 13;
+      thief->seed ^= thief->seed >> 7;
+      thief->seed ^= thief->seed << 17;
+      start = static_cast<size_t>(thief->seed % count);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      Worker* victim = workers[(start + i) % count].get();
+      if (victim != thief && victim->deque.steal(task)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Block until a task is queued or the scheduler stops
+  void sleep() {
+    std::unique_lock<std::mutex> lock(idle_lock);
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    wake.wait(lock, [this] {
+      return stopping.load(std::memory_order_relaxed) ||
+             queued.load(std::memory_order_seq_cst) != 0;
+    });
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void workerLoop(unsigned index) {
+    currentWorker() = workers[index].get();
+
+    unsigned idle = 0;
+    while (!stopping.load(std::memory_order_relaxed)) {
+      if (runOne()) {
+        idle = 0;
+      } else if (++idle < SPINS_BEFORE_SLEEP) {
+        std::this_thread::yield();
+      } else {
+        sleep();
+        idle = 0;
+      }
+    }
+    currentWorker() = nullptr;
+  }
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <type_traits>
+
+#include "../Utility/epoch-reclamation.hpp"
+#include "../Utility/ring-buffer-utils.hpp"
+
+// Chase-Lev work-stealing deque, after the C11 version of Le, Pop, Cohen
+// and Zappa Nardelli ("Correct and efficient work-stealing for weak memory
+// models", PPoPP 2013). Their fences are folded into the neighbouring
+// accesses (a release store, seq_cst loads and stores); that costs the same
+// instructions on x86 and lets ThreadSanitizer follow the synchronization.
+//
+// One owner thread uses the bottom end like ArrayStack: push and pop are
+// LIFO and take no read-modify-write atomics, except a CAS when pop races
+// thieves for the last element. Any other thread can steal from the top
+// end, which holds the oldest element. In a task scheduler, that is the
+// largest piece of work left.
+//
+// The elements live in a circular array that the owner doubles when it is
+// full. Thieves may still be reading the old array, so it is retired
+// through EpochReclamation rather than freed. Steals run inside a Guard.
+//
+// A thief reads its element before the CAS that claims it, and may read
+// a slot the owner is overwriting. So T must be trivially copyable;
+// typically it is a pointer to a task.
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "WorkStealingDeque elements must be trivially copyable");
+
+ private:
+  struct Buffer {
+    const int64_t mask;
+    std::atomic<T>* const slots;
+
+    explicit Buffer(int64_t capacity)
+        : mask{capacity - 1}, slots{new std::atomic<T>[capacity]} {}
+    ~Buffer() { delete[] slots; }
+
+    int64_t capacity() const { return mask + 1; }
+
+    T get(int64_t i) const {
+      return slots[i & mask].load(std::memory_order_relaxed);
+    }
+
+    void put(int64_t i, T item) {
+      slots[i & mask].store(item, std::memory_order_relaxed);
+    }
+  };
+
+ public:
+  explicit WorkStealingDeque(size_t min_capacity = 64)
+      : top{0}, bottom{0},
+        buffer{new Buffer(static_cast<int64_t>(
+            next_power_of_two(min_capacity > 0 ? min_capacity : 1)))} {}
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // Not thread-safe: no other thread may use the deque any more
+  ~WorkStealingDeque() { delete buffer.load(std::memory_order_relaxed); }
+
+  // Owner only
+  void push(T item) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Buffer* array = buffer.load(std::memory_order_relaxed);
+    if (b - t > array->mask) {
+      array = grow(array, t, b);
+    }
+
+    array->put(b, item);
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  // Owner only. Takes the newest element; returns false if there is none
+  bool pop(T& item) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* array = buffer.load(std::memory_order_relaxed);
+    // Claim the bottom slot before looking at top; a thief does the
+    // opposite, so at most one of them misses the other's update
+    bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_seq_cst);
+
+    if (t > b) {
+      // Empty
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    item = array->get(b);
+    if (t == b) {
+      // The last element: a thief may be claiming it too
+      bool won = top.compare_exchange_strong(t, t + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // Any thread. Takes the oldest element; returns false if the deque was
+  // empty or another thread took that element first
+  bool steal(T& item) {
+    EpochReclamation::Guard guard;
+
+    int64_t t = top.load(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_seq_cst);
+    if (t >= b) {
+      return false;
+    }
+
+    Buffer* array = buffer.load(std::memory_order_acquire);
+    T candidate = array->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      return false;
+    }
+    item = candidate;
+    return true;
+  }
+
+  // A snapshot; other threads may change it right away
+  size_t size() const {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+  }
+
+  bool isEmpty() const { return size() == 0; }
+
+ private:
+  // Thieves' end, and the owner's end plus the array it owns
+  alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top;
+  alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom;
+  std::atomic<Buffer*> buffer;
+
+  // Copy [t, b) into an array twice the size; indices keep their meaning
+  Buffer* grow(Buffer* old, int64_t t, int64_t b) {
+    Buffer* bigger = new Buffer(2 * old->capacity());
+    for (int64_t i = t; i < b; i++) {
+      bigger->put(i, old->get(i));
+    }
+    buffer.store(bigger, std::memory_order_release);
+    EpochReclamation::retire(old);
+    return bigger;
+  }
+};
+
+#endif
@@ -0,0 +1,519 @@
+#ifndef B_PLUS_TREE_H
+#define B_PLUS_TREE_H
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../Dynamic Arrays/simd-kernels.hpp"
+
+// Ordered set with the interface of BinarySearchTree, stored as a B+-tree.
+// Every node is a block of about NodeBytes holding its keys in one sorted
+// array, so a lookup touches one block per level (a handful of levels even
+// for millions of keys) instead of one node per comparison. Values live only
+// in the leaves, which are linked in order; inner nodes hold separator keys.
+//
+// Within a node, arithmetic keys are located with SimdKernels::countLess, a
+// branch-free (AVX2 where available) count of the smaller keys; other key
+// types use a binary search.
+//
+// T must be default constructible and assignable. Duplicates are ignored.
+template <typename T, size_t NodeBytes = 512>
+class BPlusTree {
+ private:
+  struct Node {
+    bool leaf;
+    size_t count;  // Keys in use
+
+    explicit Node(bool isLeaf) : leaf{isLeaf}, count{0} {}
+  };
+
+  static const size_t LEAF_BYTES = sizeof(Node) + 2 * sizeof(void*);
+  static const size_t INNER_BYTES = sizeof(Node) + sizeof(void*);
+
+ public:
+  static const size_t LEAF_CAPACITY =
+      NodeBytes > LEAF_BYTES + 3 * sizeof(T)
+          ? (NodeBytes - LEAF_BYTES) / sizeof(T)
+          : 3;
+  static const size_t INNER_CAPACITY =
+      NodeBytes > INNER_BYTES + 3 * (sizeof(T) + sizeof(void*))
+          ? (NodeBytes - INNER_BYTES) / (sizeof(T) + sizeof(void*))
+          : 3;
+
+ private:
+  struct Leaf : Node {
+    Leaf* next;
+    Leaf* prev;
+    T keys[LEAF_CAPACITY];
+
+    Leaf() : Node(true), next{nullptr}, prev{nullptr} {}
+  };
+
+  // children[i] holds the keys in [keys[i - 1], keys[i])
+  struct Inner : Node {
+    T keys[INNER_CAPACITY];
+    Node* children[INNER_CAPACITY + 1];
+
+    Inner() : Node(false) {}
+  };
+
+  Node* root;
+  Leaf* first;
+  Leaf* last;
+  size_t m_size;
+  size_t m_height;
+
+ public:
+  BPlusTree()
+      : root{nullptr}, first{nullptr}, last{nullptr}, m_size{0}, m_height{0} {}
+
+  BPlusTree(const BPlusTree& other) : BPlusTree() {
+    if (other.root != nullptr) {
+      Leaf* previous = nullptr;
+      root = copyRecursive(other.root, previous);
+      last = previous;
+      m_size = other.m_size;
+      m_height = other.m_height;
+    }
+  }
+
+  BPlusTree(BPlusTree&& other) : BPlusTree() { swap(other); }
+
+  BPlusTree& operator=(const BPlusTree& other) {
+    if (this != &other) {
+      BPlusTree temp(other);
+      swap(temp);
+    }
+    return *this;
+  }
+
+  BPlusTree& operator=(BPlusTree&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  ~BPlusTree() { clear(); }
+
+  // Core operations
+  void insert(const T& value) {
+    if (root == nullptr) {
+      first = last = new Leaf();
+      root = first;
+      m_height = 1;
+    }
+
+    T separator;
+    Node* right = nullptr;
+    if (!insertRecursive(root, value, separator, right)) {
+      return;
+    }
+    ++m_size;
+
+    // The root split, so the tree grows a level
+    if (right != nullptr) {
+      Inner* newRoot = new Inner();
+      newRoot->keys[0] = std::move(separator);
+      newRoot->children[0] = root;
+      newRoot->children[1] = right;
+      newRoot->count = 1;
+      root = newRoot;
+      ++m_height;
+    }
+  }
+
+  void remove(const T& value) {
+    if (root == nullptr || !removeRecursive(root, value)) {
+      return;
+    }
+    --m_size;
+
+    // An inner root left with a single child is dropped
+    if (root->count == 0) {
+      Node* old = root;
+      root = root->leaf ? nullptr : static_cast<Inner*>(root)->children[0];
+      if (root == nullptr) {
+        first = last = nullptr;
+      }
+      destroyNode(old);
+      --m_height;
+    }
+  }
+
+  bool contains(const T& value) const {
+    if (root == nullptr) {
+      return false;
+    }
+
+    const Node* node = root;
+    while (!node->leaf) {
+      const Inner* inner = static_cast<const Inner*>(node);
+      node = inner->children[childIndex(inner, value)];
+    }
+
+    const Leaf* leaf = static_cast<const Leaf*>(node);
+    size_t pos = lowerBound(leaf->keys, leaf->count, value);
+    return pos < leaf->count && !(value < leaf->keys[pos]);
+  }
+
+  // Additional operations
+  bool isEmpty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+  size_t height() const { return m_height; }
+
+  T findMin() const {
+    if (isEmpty()) {
+      throw std::runtime_error("Operation cannot be performed on empty tree");
+    }
+    return first->keys[0];
+  }
+
+  T findMax() const {
+    if (isEmpty()) {
+      throw std::runtime_error("Operation cannot be performed on empty tree");
+    }
+    return last->keys[last->count - 1];
+  }
+
+  void clear() {
+    if (root != nullptr) {
+      destroyRecursive(root);
+    }
+    root = nullptr;
+    first = last = nullptr;
+    m_size = 0;
+    m_height = 0;
+  }
+
+  // Traversal, along the leaf chain
+  void inOrderTraversal(void (*visit)(const T&)) const {
+    for (const Leaf* leaf = first; leaf != nullptr; leaf = leaf->next) {
+      for (size_t i = 0; i < leaf->count; i++) {
+        visit(leaf->keys[i]);
+      }
+    }
+  }
+
+ private:
+  void swap(BPlusTree& other) {
+    std::swap(root, other.root);
+    std::swap(first, other.first);
+    std::swap(last, other.last);
+    std::swap(m_size, other.m_size);
+    std::swap(m_height, other.m_height);
+  }
+
+  // Index of the first of count sorted keys that is not less than value
+  static size_t lowerBound(const T* keys, size_t count, const T& value) {
+    if (std::is_arithmetic<T>::value) {
+      return SimdKernels<T>::countLess(keys, count, value);
+    }
+    return std::lower_bound(keys, keys + count, value) - keys;
+  }
+
+  // The child whose range holds value: the number of separators <= value
+  static size_t childIndex(const Inner* node, const T& value) {
+    size_t pos = lowerBound(node->keys, node->count, value);
+    return pos + (pos < node->count && !(value < node->keys[pos]));
+  }
+
+  static size_t minKeys(const Node* node) {
+    return node->leaf ? LEAF_CAPACITY / 2 : INNER_CAPACITY / 2;
+  }
+
+  static void insertKey(T* keys, size_t count, size_t pos, T value) {
+    std::move_backward(keys + pos, keys + count, keys + count + 1);
+    keys[pos] = std::move(value);
+  }
+
+  static void eraseKey(T* keys, size_t count, size_t pos) {
+    std::move(keys + pos + 1, keys + count, keys + pos);
+  }
+
+  static void destroyNode(Node* node) {
+    if (node->leaf) {
+      delete static_cast<Leaf*>(node);
+    } else {
+      delete static_cast<Inner*>(node);
+    }
+  }
+
+  // Recursion is bounded by the height, which stays small
+  static void destroyRecursive(Node* node) {
+    if (!node->leaf) {
+      Inner* inner = static_cast<Inner*>(node);
+      for (size_t i = 0; i <= inner->count; i++) {
+        destroyRecursive(inner->children[i]);
+      }
+    }
+    destroyNode(node);
+  }
+
+  // Copies the subtree, linking its leaves after previous
+  Node* copyRecursive(const Node* node, Leaf*& previous) {
+    if (node->leaf) {
+      const Leaf* source = static_cast<const Leaf*>(node);
+      Leaf* leaf = new Leaf();
+      std::copy(source->keys, source->keys + source->count, leaf->keys);
+      leaf->count = source->count;
+
+      leaf->prev = previous;
+      if (previous != nullptr) {
+        previous->next = leaf;
+      } else {
+        first = leaf;
+      }
+      previous = leaf;
+      return leaf;
+    }
+
+    const Inner* source = static_cast<const Inner*>(node);
+    Inner* inner = new Inner();
+    std::copy(source->keys, source->keys + source->count, inner->keys);
+    inner->count = source->count;
+    for (size_t i = 0; i <= source->count; i++) {
+      inner->children[i] = copyRecursive(source->children[i], previous);
+    }
+    return inner;
+  }
+
+  // Insert value below node. If node had to split, its new right sibling is
+  // returned through right, with the separator that routes keys to it
+  bool insertRecursive(Node* node, const T& value, T& separator,
+                       Node*& right) {
+    if (node->leaf) {
+      return insertIntoLeaf(static_cast<Leaf*>(node), value, separator,
+                            right);
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    size_t index = childIndex(inner, value);
+
+    T childSeparator;
+    Node* childRight = nullptr;
+    if (!insertRecursive(inner->children[index], value, childSeparator,
+                         childRight)) {
+      return false;
+    }
+
+    if (childRight != nullptr) {
+      insertChild(inner, index, std::move(childSeparator), childRight,
+                  separator, right);
+    }
+    return true;
+  }
+
+  bool insertIntoLeaf(Leaf* leaf, const T& value, T& separator,
+                      Node*& right) {
+    size_t pos = lowerBound(leaf->keys, leaf->count, value);
+    if (pos < leaf->count && !(value < leaf->keys[pos])) {
+      return false;
+    }
+
+    if (leaf->count < LEAF_CAPACITY) {
+      insertKey(leaf->keys, leaf->count++, pos, value);
+      return true;
+    }
+
+    // Split the full leaf in half and link the new one after it
+    Leaf* sibling = new Leaf();
+    size_t keep = (LEAF_CAPACITY + 1) / 2;
+    std::move(leaf->keys + keep, leaf->keys + LEAF_CAPACITY, sibling->keys);
+    sibling->count = LEAF_CAPACITY - keep;
+    leaf->count = keep;
+
+    sibling->prev = leaf;
+    sibling->next = leaf->next;
+    if (leaf->next != nullptr) {
+      leaf->next->prev = sibling;
+    } else {
+      last = sibling;
+    }
+    leaf->next = sibling;
+
+    if (pos <= keep) {
+      insertKey(leaf->keys, leaf->count++, pos, value);
+    } else {
+      insertKey(sibling->keys, sibling->count++, pos - keep, value);
+    }
+
+    separator = sibling->keys[0];
+    right = sibling;
+    return true;
+  }
+
+  // Add child to the right of children[index], with key separating the two
+  void insertChild(Inner* node, size_t index, T key, Node* child,
+                   T& separator, Node*& right) {
+    if (node->count < INNER_CAPACITY) {
+      insertKey(node->keys, node->count, index, std::move(key));
+      std::move_backward(node->children + index + 1,
+                         node->children + node->count + 1,
+                         node->children + node->count + 2);
+      node->children[index + 1] = child;
+      ++node->count;
+      return;
+    }
+
+    // Lay out the overfull node, then push its middle key up
+    T keys[INNER_CAPACITY + 1];
+    Node* children[INNER_CAPACITY + 2];
+    std::move(node->keys, node->keys + INNER_CAPACITY, keys);
+    std::copy(node->children, node->children + INNER_CAPACITY + 1, children);
+    insertKey(keys, INNER_CAPACITY, index, std::move(key));
+    std::copy_backward(children + index + 1, children + INNER_CAPACITY + 1,
+                       children + INNER_CAPACITY + 2);
+    children[index + 1] = child;
+
+    const size_t total = INNER_CAPACITY + 1;
+    size_t keep = total / 2;
+    Inner* sibling = new Inner();
+
+    std::move(keys, keys + keep, node->keys);
+    std::copy(children, children + keep + 1, node->children);
+    node->count = keep;
+
+    std::move(keys + keep + 1, keys + total, sibling->keys);
+    std::copy(children + keep + 1, children + total + 1, sibling->children);
+    sibling->count = total - keep - 1;
+
+    separator = std::move(keys[keep]);
+    right = sibling;
+  }
+
+  // Remove value below node; an underfull child is fixed up on the way back
+  bool removeRecursive(Node* node, const T& value) {
+    if (node->leaf) {
+      Leaf* leaf = static_cast<Leaf*>(node);
+      size_t pos = lowerBound(leaf->keys, leaf->count, value);
+      if (pos == leaf->count || value < leaf->keys[pos]) {
+        return false;
+      }
+      eraseKey(leaf->keys, leaf->count--, pos);
+      return true;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    size_t index = childIndex(inner, value);
+    Node* child = inner->children[index];
+    if (!removeRecursive(child, value)) {
+      return false;
+    }
+
+    if (child->count < minKeys(child)) {
+      rebalanceChild(inner, index);
+    }
+    return true;
+  }
+
+  // Borrow a key from a sibling that can spare one, otherwise merge with it
+  void rebalanceChild(Inner* parent, size_t index) {
+    Node* left = index > 0 ? parent->children[index - 1] : nullptr;
+    Node* right =
+        index < parent->count ? parent->children[index + 1] : nullptr;
+
+    if (left != nullptr && left->count > minKeys(left)) {
+      borrowFromLeft(parent, index);
+    } else if (right != nullptr && right->count > minKeys(right)) {
+      borrowFromRight(parent, index);
+    } else if (left != nullptr) {
+      mergeChildren(parent, index - 1);
+    } else {
+      mergeChildren(parent, index);
+    }
+  }
+
+  static void borrowFromLeft(Inner* parent, size_t index) {
+    Node* child = parent->children[index];
+    Node* sibling = parent->children[index - 1];
+
+    if (child->leaf) {
+      Leaf* to = static_cast<Leaf*>(child);
+      Leaf* from = static_cast<Leaf*>(sibling);
+      insertKey(to->keys, to->count++, 0,
+                std::move(from->keys[--from->count]));
+      parent->keys[index - 1] = to->keys[0];
+      return;
+    }
+
+    // Rotate through the parent: its separator comes down, the sibling's
+    // last key goes up
+    Inner* to = static_cast<Inner*>(child);
+    Inner* from = static_cast<Inner*>(sibling);
+    insertKey(to->keys, to->count, 0, std::move(parent->keys[index - 1]));
+    std::move_backward(to->children, to->children + to->count + 1,
+                       to->children + to->count + 2);
+    to->children[0] = from->children[from->count];
+    ++to->count;
+    parent->keys[index - 1] = std::move(from->keys[--from->count]);
+  }
+
+  static void borrowFromRight(Inner* parent, size_t index) {
+    Node* child = parent->children[index];
+    Node* sibling = parent->children[index + 1];
+
+    if (child->leaf) {
+      Leaf* to = static_cast<Leaf*>(child);
+      Leaf* from = static_cast<Leaf*>(sibling);
+      to->keys[to->count++] = std::move(from->keys[0]);
+      eraseKey(from->keys, from->count--, 0);
+      parent->keys[index] = from->keys[0];
+      return;
+    }
+
+    Inner* to = static_cast<Inner*>(child);
+    Inner* from = static_cast<Inner*>(sibling);
+    to->keys[to->count] = std::move(parent->keys[index]);
+    to->children[to->count + 1] = from->children[0];
+    ++to->count;
+    parent->keys[index] = std::move(from->keys[0]);
+    eraseKey(from->keys, from->count, 0);
+    std::move(from->children + 1, from->children + from->count + 1,
+              from->children);
+    --from->count;
+  }
+
+  // Fold children[index + 1] into children[index] and drop their separator
+  void mergeChildren(Inner* parent, size_t index) {
+    Node* left = parent->children[index];
+    Node* right = parent->children[index + 1];
+
+    if (left->leaf) {
+      Leaf* to = static_cast<Leaf*>(left);
+      Leaf* from = static_cast<Leaf*>(right);
+      std::move(from->keys, from->keys + from->count, to->keys + to->count);
+      to->count += from->count;
+
+      to->next = from->next;
+      if (from->next != nullptr) {
+        from->next->prev = to;
+      } else {
+        last = to;
+      }
+    } else {
+      Inner* to = static_cast<Inner*>(left);
+      Inner* from = static_cast<Inner*>(right);
+      to->keys[to->count] = std::move(parent->keys[index]);
+      std::move(from->keys, from->keys + from->count,
+                to->keys + to->count + 1);
+      std::copy(from->children, from->children + from->count + 1,
+                to->children + to->count + 1);
+      to->count += from->count + 1;
+    }
+    destroyNode(right);
+
+    eraseKey(parent->keys, parent->count, index);
+    std::move(parent->children + index + 2,
+              parent->children + parent->count + 1,
+              parent->children + index + 1);
+    --parent->count;
+  }
+};
+
+#endif
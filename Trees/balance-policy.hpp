@@ -0,0 +1,131 @@
+#ifndef BALANCE_POLICY_H
+#define BALANCE_POLICY_H
+
+#include <stdlib.h>
+
+#include <utility>
+#include <vector>
+
+// Balance policies for BinarySearchTree. A policy provides:
+//   REBALANCES          - false if update and rebalance never change
+//                         anything, so the tree need not revisit the path
+//                         above a change
+//   NodeData            - extra fields every node inherits
+//   update(node)        - recompute those fields from the node's children
+//   height(node)        - height of the subtree at node (0 for null)
+//   rebalance(node)     - restore the invariant at node (whose subtrees are
+//                         already valid) and return the new subtree root
+// Rotations call node->refresh(), which lets the tree refresh its own
+// per-node bookkeeping alongside the policy's.
+
+// Plain binary search tree: no rebalancing, no per-node overhead
+struct NoBalancing {
+  static const bool REBALANCES = false;
+
+  struct NodeData {};
+
+  template <typename Node>
+  static void update(Node*) {}
+
+  template <typename Node>
+  static Node* rebalance(Node* node) {
+    return node;
+  }
+
+  // Nothing is stored, so walk the subtree depth-first from an explicit
+  // stack; a degenerate tree is as deep as it is large
+  template <typename Node>
+  static size_t height(const Node* node) {
+    size_t deepest = 0;
+    std::vector<std::pair<const Node*, size_t>> pending;
+    if (node != nullptr) {
+      pending.emplace_back(node, 1);
+    }
+
+    while (!pending.empty()) {
+      const Node* current = pending.back().first;
+      size_t depth = pending.back().second;
+      pending.pop_back();
+
+      if (depth > deepest) {
+        deepest = depth;
+      }
+      if (current->left != nullptr) {
+        pending.emplace_back(current->left, depth + 1);
+      }
+      if (current->right != nullptr) {
+        pending.emplace_back(current->right, depth + 1);
+      }
+    }
+    return deepest;
+  }
+};
+
+// AVL tree: sibling subtree heights differ by at most one, which bounds the
+// height by about 1.44 log2(n)
+struct AVLBalancing {
+  static const bool REBALANCES = true;
+
+  struct NodeData {
+    size_t height = 1;
+  };
+
+  // Kept in every node, so O(1)
+  template <typename Node>
+  static size_t height(const Node* node) {
+    return node != nullptr ? node->height : 0;
+  }
+
+  template <typename Node>
+  static void update(Node* node) {
+    size_t leftHeight = height(node->left);
+    size_t rightHeight = height(node->right);
+    node->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+  }
+
+  template <typename Node>
+  static Node* rotateLeft(Node* node) {
+    Node* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    node->refresh();
+    pivot->refresh();
+    return pivot;
+  }
+
+  template <typename Node>
+  static Node* rotateRight(Node* node) {
+    Node* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    node->refresh();
+    pivot->refresh();
+    return pivot;
+  }
+
+  template <typename Node>
+  static Node* rebalance(Node* node) {
+    size_t leftHeight = height(node->left);
+    size_t rightHeight = height(node->right);
+
+    // Left-heavy: a left-right shape needs an extra rotation first
+    if (leftHeight > rightHeight + 1) {
+      if (height(node->left->left) < height(node->left->right)) {
+        node->left = rotateLeft(node->left);
+      }
+      return rotateRight(node);
+    }
+
+    // Right-heavy, mirrored
+    if (rightHeight > leftHeight + 1) {
+      if (height(node->right->right) < height(node->right->left)) {
+        node->right = rotateRight(node->right);
+      }
+      return rotateLeft(node);
+    }
+
+    return node;
+  }
+};
+
+#endif
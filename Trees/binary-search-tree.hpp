@@ -3,39 +3,166 @@
 
 #include <stdlib.h>
 
-template <typename T>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "balance-policy.hpp"
+#include "eytzinger-index.hpp"
+
+// BalancePolicy selects how the tree keeps itself balanced (see
+// balance-policy.hpp); the default is a plain unbalanced tree
+template <typename T, typename BalancePolicy = NoBalancing>
 class BinarySearchTree {
  private:
-  struct Node {
+  struct Node : BalancePolicy::NodeData {
     T data;
     Node* left;
     Node* right;
+    size_t count;  // Nodes in the subtree rooted here
+
+    Node(const T& value)
+        : data{value}, left{nullptr}, right{nullptr}, count{1} {}
 
-    Node(const T& value) : data{value}, left{nullptr}, right{nullptr} {}
+    // Recompute the bookkeeping derived from the children
+    void refresh() {
+      count = 1 + countOf(left) + countOf(right);
+      BalancePolicy::update(this);
+    }
+  };
+
+  static size_t countOf(const Node* node) {
+    return node != nullptr ? node->count : 0;
+  }
+
+  // Nodes from the root down, kept while descending so the bookkeeping
+  // above a change can be fixed up afterwards without recursion. An AVL
+  // tree of fewer than 2^64 nodes is at most 92 high, so a balanced tree's
+  // path fits the fixed array; only an unbalanced tree can spill past it
+  struct Path {
+    static const size_t INLINE = 96;
+
+    Node* nodes[INLINE];
+    size_t length = 0;
+    std::vector<Node*> spill;
+
+    void push_back(Node* node) {
+      if (length < INLINE) {
+        nodes[length] = node;
+      } else {
+        spill.push_back(node);
+      }
+      ++length;
+    }
+    size_t size() const { return length; }
+    Node* operator[](size_t i) const {
+      return i < INLINE ? nodes[i] : spill[i - INLINE];
+    }
   };
 
   Node* root;
 
   // Helper Functions
-  void destroyRecursive(Node* node);
-  Node* insertRecursive(Node* node, const T& value);
-  Node* findMinNode(Node* node) const;
-  Node* removeRecursive(Node* node, const T& value);
-  void inOrderTraversalRecursive(Node* node, void (*visit)(const T&)) const;
-  Node* copyRecursive(const Node* node);
-  bool containsRecursive(Node* node, const T& value) const;
-  size_t sizeRecursive(Node* node) const;
-  size_t heightRecursive(Node* node) const;
+  static void destroyTree(Node* node);
+  static Node* copyTree(const Node* node);
+  void replaceChild(Node* parent, Node* child, Node* replacement);
+  void retrace(Path& path);
+  static void addToCounts(const Path& path, int delta);
+  static void collectInOrder(const Node* node, std::vector<T>& out);
+
+  // Call visit, treating a visitor that returns nothing as never stopping
+  template <typename Visitor>
+  static bool keepVisiting(Visitor& visit, const T& value, std::true_type) {
+    visit(value);
+    return true;
+  }
+  template <typename Visitor>
+  static bool keepVisiting(Visitor& visit, const T& value, std::false_type) {
+    return static_cast<bool>(visit(value));
+  }
+
+  template <typename ForwardIt>
+  static size_t countUniqueSorted(ForwardIt first, ForwardIt last);
+  template <typename ForwardIt>
+  static Node* buildBalanced(ForwardIt& next, ForwardIt last, size_t count);
+  template <typename InputIt>
+  static BinarySearchTree fromSortedRange(InputIt first, InputIt last,
+                                          std::input_iterator_tag);
+  template <typename ForwardIt>
+  static BinarySearchTree fromSortedRange(ForwardIt first, ForwardIt last,
+                                          std::forward_iterator_tag);
 
  public:
+  // Forward iterator over the values in ascending order. It keeps the path
+  // of ancestors still to be visited, so advancing is amortized O(1) and
+  // needs no parent pointers. Modifying the tree invalidates all iterators
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const_iterator() {}
+
+    const T& operator*() const { return path.back()->data; }
+    const T* operator->() const { return &path.back()->data; }
+
+    const_iterator& operator++() {
+      const Node* node = path.back()->right;
+      path.pop_back();
+      pushLeftPath(node);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator& rhs) const {
+      return current() == rhs.current();
+    }
+    bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+   private:
+    friend class BinarySearchTree;
+
+    std::vector<const Node*> path;
+
+    const Node* current() const {
+      return path.empty() ? nullptr : path.back();
+    }
+
+    void pushLeftPath(const Node* node) {
+      while (node != nullptr) {
+        path.push_back(node);
+        node = node->left;
+      }
+    }
+  };
+
+  using iterator = const_iterator;
+
   // Constructor and destructor
   BinarySearchTree() : root(nullptr) {}
 
   // Copy constructor
-  BinarySearchTree(const BinarySearchTree<T>& other);
+  BinarySearchTree(const BinarySearchTree& other);
+
+  // Move constructor
+  BinarySearchTree(BinarySearchTree&& other) : root(other.root) {
+    other.root = nullptr;
+  }
 
-  // Assignment operator
-  BinarySearchTree<T>& operator=(const BinarySearchTree<T>& other);
+  // Assignment operators
+  BinarySearchTree& operator=(const BinarySearchTree& other);
+  BinarySearchTree& operator=(BinarySearchTree&& other);
 
   // Destructor
   ~BinarySearchTree();
@@ -53,277 +180,599 @@ class BinarySearchTree {
   T findMax() const;
   void clear();
 
-  // Traversal
+  // Build a perfectly balanced tree in O(n) from a range sorted in ascending
+  // order; duplicates are dropped. Throws std::invalid_argument if the range
+  // is not sorted
+  template <typename InputIt>
+  static BinarySearchTree fromSorted(InputIt first, InputIt last);
+
+  // Add the values of other by merging both in-order sequences and
+  // rebuilding a balanced tree, O(n + m)
+  void mergeWith(const BinarySearchTree& other);
+
+  // Immutable contiguous copy of the values for read-only lookups
+  EytzingerIndex<T> freeze() const;
+
+  // Order statistics, O(height)
+  T select(size_t k) const;
+  size_t rank(const T& value) const;
+  size_t countRange(const T& lo, const T& hi) const;
+
+  // Iteration
+  const_iterator begin() const;
+  const_iterator end() const { return const_iterator(); }
+  const_iterator lower_bound(const T& value) const;  // First value >= value
+  const_iterator upper_bound(const T& value) const;  // First value > value
+
+  // Traversal, iterative so deep trees cannot overflow the stack. A visitor
+  // may return bool; returning false stops the traversal
   void inOrderTraversal(void (*visit)(const T&)) const;
+  template <typename Visitor>
+  void inOrderTraversal(Visitor&& visit) const;
+
+  // Visit the values in the closed range [lo, hi] in order, touching
+  // O(height + k) nodes; visit may return false to stop early
+  template <typename Visitor>
+  void forEachInRange(const T& lo, const T& hi, Visitor&& visit) const;
 };
 
 // Copy constructor
-template <typename T>
-BinarySearchTree<T>::BinarySearchTree(const BinarySearchTree<T>& other)
+template <typename T, typename BalancePolicy>
+BinarySearchTree<T, BalancePolicy>::BinarySearchTree(
+    const BinarySearchTree& other)
     : root(nullptr) {
-  root = copyRecursive(other.root);
+  root = copyTree(other.root);
 }
 
-// Copy helper
-template <typename T>
-typename BinarySearchTree<T>::Node* BinarySearchTree<T>::copyRecursive(
-    const Node* node) {
-  if (node == nullptr) {
-    return nullptr;
+// Copy helper. Every node is copied with its bookkeeping, so the copy needs
+// no refresh and can be built top-down from an explicit stack. If a copy
+// throws, the part built so far is freed
+template <typename T, typename BalancePolicy>
+typename BinarySearchTree<T, BalancePolicy>::Node*
+BinarySearchTree<T, BalancePolicy>::copyTree(const Node* node) {
+  Node* copy = nullptr;
+  std::vector<std::pair<const Node*, Node**>> pending;
+  if (node != nullptr) {
+    pending.emplace_back(node, &copy);
   }
 
-  Node* newNode = new Node(node->data);
-  newNode->left = copyRecursive(node->left);
-  newNode->right = copyRecursive(node->right);
-
-  return newNode;
+  try {
+    while (!pending.empty()) {
+      const Node* source = pending.back().first;
+      Node** link = pending.back().second;
+      pending.pop_back();
+
+      Node* newNode = new Node(*source);
+      newNode->left = nullptr;
+      newNode->right = nullptr;
+      *link = newNode;
+
+      if (source->right != nullptr) {
+        pending.emplace_back(source->right, &newNode->right);
+      }
+      if (source->left != nullptr) {
+        pending.emplace_back(source->left, &newNode->left);
+      }
+    }
+  } catch (...) {
+    destroyTree(copy);
+    throw;
+  }
+  return copy;
 }
 
 // Assignment operator
-template <typename T>
-BinarySearchTree<T>& BinarySearchTree<T>::operator=(
-    const BinarySearchTree<T>& other) {
+template <typename T, typename BalancePolicy>
+BinarySearchTree<T, BalancePolicy>&
+BinarySearchTree<T, BalancePolicy>::operator=(const BinarySearchTree& other) {
   if (this != &other) {
     // Clear existing tree
     clear();
 
     // Copy the other tree
-    root = copyRecursive(other.root);
+    root = copyTree(other.root);
+  }
+  return *this;
+}
+
+// Move assignment operator
+template <typename T, typename BalancePolicy>
+BinarySearchTree<T, BalancePolicy>&
+BinarySearchTree<T, BalancePolicy>::operator=(BinarySearchTree&& other) {
+  if (this != &other) {
+    clear();
+    root = other.root;
+    other.root = nullptr;
   }
   return *this;
 }
 
 // Destructor
-template <typename T>
-BinarySearchTree<T>::~BinarySearchTree() {
+template <typename T, typename BalancePolicy>
+BinarySearchTree<T, BalancePolicy>::~BinarySearchTree() {
   clear();
 }
 
 // Clear the tree
-template <typename T>
-void BinarySearchTree<T>::clear() {
-  destroyRecursive(root);
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::clear() {
+  destroyTree(root);
   root = nullptr;
 }
 
-// Helper method to destroy the tree recursively
-template <typename T>
-void BinarySearchTree<T>::destroyRecursive(Node* node) {
-  if (node != nullptr) {
-    destroyRecursive(node->left);
-    destroyRecursive(node->right);
-    delete node;
+// Helper method to destroy the tree. Left children are rotated up until the
+// node has none, then it is deleted; this needs no stack, so even a
+// degenerate chain is freed safely
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::destroyTree(Node* node) {
+  while (node != nullptr) {
+    if (node->left != nullptr) {
+      Node* left = node->left;
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      Node* right = node->right;
+      delete node;
+      node = right;
+    }
   }
 }
 
-// Insert a value into the tree
-template <typename T>
-void BinarySearchTree<T>::insert(const T& value) {
-  root = insertRecursive(root, value);
+// Insert a value into the tree. The link to fill is found first, so a
+// duplicate or a failed allocation leaves the tree untouched; only then are
+// the subtree sizes on the path raised
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::insert(const T& value) {
+  Path path;
+  Node** link = &root;
+  while (*link != nullptr) {
+    Node* node = *link;
+    if (value < node->data) {
+      link = &node->left;
+    } else if (value > node->data) {
+      link = &node->right;
+    } else {
+      // Duplicates are ignored
+      return;
+    }
+    path.push_back(node);
+  }
+
+  *link = new Node(value);
+  if (BalancePolicy::REBALANCES) {
+    retrace(path);
+  } else {
+    addToCounts(path, 1);
+  }
 }
 
-// Helper method to insert recursively
-template <typename T>
-typename BinarySearchTree<T>::Node* BinarySearchTree<T>::insertRecursive(
-    Node* node, const T& value) {
+// Check if the tree contains a value
+template <typename T, typename BalancePolicy>
+bool BinarySearchTree<T, BalancePolicy>::contains(const T& value) const {
+  Node* node = root;
+  while (node != nullptr) {
+    if (value == node->data) {
+      return true;
+    }
+    node = value < node->data ? node->left : node->right;
+  }
+  return false;
+}
+
+// Remove a value from the tree
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::remove(const T& value) {
+  Path path;
+  Node* parent = nullptr;
+  Node* node = root;
+  while (node != nullptr && !(value == node->data)) {
+    path.push_back(node);
+    parent = node;
+    node = value < node->data ? node->left : node->right;
+  }
   if (node == nullptr) {
-    return new Node(value);
+    return;
   }
 
-  if (value < node->data) {
-    node->left = insertRecursive(node->left, value);
-  } else if (value > node->data) {
-    node->right = insertRecursive(node->right, value);
+  if (node->left != nullptr && node->right != nullptr) {
+    // Two children: take over the data of the inorder successor (smallest
+    // node in the right subtree) and unlink that node instead
+    path.push_back(node);
+    parent = node;
+    Node* successor = node->right;
+    while (successor->left != nullptr) {
+      path.push_back(successor);
+      parent = successor;
+      successor = successor->left;
+    }
+    node->data = successor->data;
+    node = successor;
   }
-  // If value is equal, we can either ignore or update
-  // Here we choose to ignore duplicates
 
-  return node;
+  // node has at most one child, which takes its place
+  replaceChild(parent, node, node->left != nullptr ? node->left : node->right);
+  delete node;
+  if (BalancePolicy::REBALANCES) {
+    retrace(path);
+  } else {
+    addToCounts(path, -1);
+  }
 }
 
-// Check if the tree contains a value
-template <typename T>
-bool BinarySearchTree<T>::contains(const T& value) const {
-  return containsRecursive(root, value);
+// Without a balancing policy only the subtree sizes on the path change.
+// Adding to them directly spares retrace's reads of the siblings
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::addToCounts(const Path& path,
+                                                     int delta) {
+  for (size_t i = 0; i < path.size(); i++) {
+    path[i]->count += delta;
+  }
 }
 
-// Helper method to check recursively
-template <typename T>
-bool BinarySearchTree<T>::containsRecursive(Node* node, const T& value) const {
-  if (node == nullptr) {
-    return false;
+// Point parent's link to child at replacement instead; a null parent means
+// child is the root
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::replaceChild(Node* parent,
+                                                      Node* child,
+                                                      Node* replacement) {
+  if (parent == nullptr) {
+    root = replacement;
+  } else if (parent->left == child) {
+    parent->left = replacement;
+  } else {
+    parent->right = replacement;
   }
+}
 
-  if (value == node->data) {
-    return true;
-  } else if (value < node->data) {
-    return containsRecursive(node->left, value);
-  } else {
-    return containsRecursive(node->right, value);
+// Refresh and rebalance the nodes on path, deepest first, after a change
+// below them. A rotation returns a new subtree root, which is linked into
+// the parent in place of the old one
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::retrace(Path& path) {
+  for (size_t i = path.size(); i-- > 0;) {
+    Node* node = path[i];
+    node->refresh();
+    Node* balanced = BalancePolicy::rebalance(node);
+    if (balanced != node) {
+      replaceChild(i > 0 ? path[i - 1] : nullptr, node, balanced);
+    }
   }
 }
 
-// Remove a value from the tree
-template <typename T>
-void BinarySearchTree<T>::remove(const T& value) {
+// Check if the tree is empty
+template <typename T, typename BalancePolicy>
+bool BinarySearchTree<T, BalancePolicy>::isEmpty() const {
+  return root == nullptr;
+}
+
+// Get the size of the tree, kept at the root
+template <typename T, typename BalancePolicy>
+size_t BinarySearchTree<T, BalancePolicy>::size() const {
+  return countOf(root);
+}
+
+// Get the height of the tree: stored at the root by a balancing policy,
+// otherwise found by walking the tree
+template <typename T, typename BalancePolicy>
+size_t BinarySearchTree<T, BalancePolicy>::height() const {
+  return BalancePolicy::height(root);
+}
+
+// Find the minimum value in the tree
+template <typename T, typename BalancePolicy>
+T BinarySearchTree<T, BalancePolicy>::findMin() const {
   if (isEmpty()) {
-    return;
+    throw std::runtime_error("Operation cannot be performed on empty tree");
   }
 
-  if (!contains(value)) {
-    return;
+  Node* current = root;
+  while (current->left != nullptr) {
+    current = current->left;
   }
 
-  root = removeRecursive(root, value);
+  return current->data;
 }
 
-// Helper method to find the minimum node
-template <typename T>
-typename BinarySearchTree<T>::Node* BinarySearchTree<T>::findMinNode(
-    Node* node) const {
-  if (node == nullptr) {
-    return nullptr;
+// Find the maximum value in the tree
+template <typename T, typename BalancePolicy>
+T BinarySearchTree<T, BalancePolicy>::findMax() const {
+  if (isEmpty()) {
+    throw std::runtime_error("Operation cannot be performed on empty tree");
   }
 
-  while (node->left != nullptr) {
-    node = node->left;
+  Node* current = root;
+  while (current->right != nullptr) {
+    current = current->right;
   }
 
-  return node;
+  return current->data;
 }
 
-// Helper method to remove recursively
-template <typename T>
-typename BinarySearchTree<T>::Node* BinarySearchTree<T>::removeRecursive(
-    Node* node, const T& value) {
-  if (node == nullptr) {
-    return nullptr;
+// Find the k-th smallest value (0-based)
+template <typename T, typename BalancePolicy>
+T BinarySearchTree<T, BalancePolicy>::select(size_t k) const {
+  if (k >= size()) {
+    throw std::out_of_range("select index out of range");
   }
 
-  if (value < node->data) {
-    node->left = removeRecursive(node->left, value);
-  } else if (value > node->data) {
-    node->right = removeRecursive(node->right, value);
-  } else {
-    // Node with the value found, handle 3 cases
-
-    // Case 1: Node with no children (leaf)
-    if (node->left == nullptr && node->right == nullptr) {
-      delete node;
-      return nullptr;
+  Node* current = root;
+  while (true) {
+    size_t leftCount = countOf(current->left);
+    if (k < leftCount) {
+      current = current->left;
+    } else if (k == leftCount) {
+      return current->data;
+    } else {
+      k -= leftCount + 1;
+      current = current->right;
     }
-    // Case 2: Node with one child
-    else if (node->left == nullptr) {
-      Node* temp = node->right;
-      delete node;
-      return temp;
-    } else if (node->right == nullptr) {
-      Node* temp = node->left;
-      delete node;
-      return temp;
+  }
+}
+
+// Count the values smaller than value
+template <typename T, typename BalancePolicy>
+size_t BinarySearchTree<T, BalancePolicy>::rank(const T& value) const {
+  size_t smaller = 0;
+  Node* current = root;
+  while (current != nullptr) {
+    if (current->data < value) {
+      smaller += countOf(current->left) + 1;
+      current = current->right;
+    } else {
+      current = current->left;
     }
-    // Case 3: Node with two children
-    else {
-      // Find the inorder successor (smallest node in right subtree)
-      Node* successor = findMinNode(node->right);
+  }
+  return smaller;
+}
+
+// Count the values in the closed range [lo, hi]
+template <typename T, typename BalancePolicy>
+size_t BinarySearchTree<T, BalancePolicy>::countRange(const T& lo,
+                                                      const T& hi) const {
+  if (hi < lo) {
+    return 0;
+  }
+
+  size_t upTo = rank(hi) + (contains(hi) ? 1 : 0);
+  return upTo - rank(lo);
+}
 
-      // Copy the successor's data to this node
-      node->data = successor->data;
+// Iterator to the smallest value
+template <typename T, typename BalancePolicy>
+typename BinarySearchTree<T, BalancePolicy>::const_iterator
+BinarySearchTree<T, BalancePolicy>::begin() const {
+  const_iterator it;
+  it.pushLeftPath(root);
+  return it;
+}
 
-      // Delete the successor
-      node->right = removeRecursive(node->right, successor->data);
+// Iterator to the first value not less than value. Only the nodes where the
+// search turns left are still ahead of it
+template <typename T, typename BalancePolicy>
+typename BinarySearchTree<T, BalancePolicy>::const_iterator
+BinarySearchTree<T, BalancePolicy>::lower_bound(const T& value) const {
+  const_iterator it;
+  const Node* node = root;
+  while (node != nullptr) {
+    if (node->data < value) {
+      node = node->right;
+    } else {
+      it.path.push_back(node);
+      node = node->left;
     }
   }
+  return it;
+}
 
-  return node;
+// Iterator to the first value greater than value
+template <typename T, typename BalancePolicy>
+typename BinarySearchTree<T, BalancePolicy>::const_iterator
+BinarySearchTree<T, BalancePolicy>::upper_bound(const T& value) const {
+  const_iterator it;
+  const Node* node = root;
+  while (node != nullptr) {
+    if (value < node->data) {
+      it.path.push_back(node);
+      node = node->left;
+    } else {
+      node = node->right;
+    }
+  }
+  return it;
 }
 
-// Check if the tree is empty
-template <typename T>
-bool BinarySearchTree<T>::isEmpty() const {
-  return root == nullptr;
+// Perform an in-order traversal of the tree
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::inOrderTraversal(
+    void (*visit)(const T&)) const {
+  for (const T& value : *this) {
+    visit(value);
+  }
 }
 
-// Get the size of the tree
-template <typename T>
-size_t BinarySearchTree<T>::size() const {
-  return sizeRecursive(root);
+template <typename T, typename BalancePolicy>
+template <typename Visitor>
+void BinarySearchTree<T, BalancePolicy>::inOrderTraversal(
+    Visitor&& visit) const {
+  using ReturnsVoid =
+      typename std::is_void<decltype(visit(std::declval<const T&>()))>::type;
+
+  for (const T& value : *this) {
+    if (!keepVisiting(visit, value, ReturnsVoid())) {
+      return;
+    }
+  }
 }
 
-// Helper method to calculate size recursively
-template <typename T>
-size_t BinarySearchTree<T>::sizeRecursive(Node* node) const {
-  if (node == nullptr) {
-    return 0;
+// Visit the values between lo and hi
+template <typename T, typename BalancePolicy>
+template <typename Visitor>
+void BinarySearchTree<T, BalancePolicy>::forEachInRange(
+    const T& lo, const T& hi, Visitor&& visit) const {
+  using ReturnsVoid =
+      typename std::is_void<decltype(visit(std::declval<const T&>()))>::type;
+
+  for (const_iterator it = lower_bound(lo); it != end() && !(hi < *it);
+       ++it) {
+    if (!keepVisiting(visit, *it, ReturnsVoid())) {
+      return;
+    }
   }
+}
 
-  return 1 + sizeRecursive(node->left) + sizeRecursive(node->right);
+// Copy the values, already sorted and distinct, into a search index
+template <typename T, typename BalancePolicy>
+EytzingerIndex<T> BinarySearchTree<T, BalancePolicy>::freeze() const {
+  return EytzingerIndex<T>(begin(), end());
 }
 
-// Get the height of the tree
-template <typename T>
-size_t BinarySearchTree<T>::height() const {
-  return heightRecursive(root);
+// Bulk construction from sorted input
+template <typename T, typename BalancePolicy>
+template <typename InputIt>
+BinarySearchTree<T, BalancePolicy>
+BinarySearchTree<T, BalancePolicy>::fromSorted(InputIt first, InputIt last) {
+  return fromSortedRange(
+      first, last,
+      typename std::iterator_traits<InputIt>::iterator_category());
 }
 
-// Helper method to calculate height recursively
-template <typename T>
-size_t BinarySearchTree<T>::heightRecursive(Node* node) const {
-  if (node == nullptr) {
+// Single-pass input is buffered so it can be counted and then consumed
+template <typename T, typename BalancePolicy>
+template <typename InputIt>
+BinarySearchTree<T, BalancePolicy>
+BinarySearchTree<T, BalancePolicy>::fromSortedRange(InputIt first,
+                                                    InputIt last,
+                                                    std::input_iterator_tag) {
+  std::vector<T> values(first, last);
+  return fromSortedRange(values.begin(), values.end(),
+                         std::forward_iterator_tag());
+}
+
+template <typename T, typename BalancePolicy>
+template <typename ForwardIt>
+BinarySearchTree<T, BalancePolicy>
+BinarySearchTree<T, BalancePolicy>::fromSortedRange(
+    ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+  size_t count = countUniqueSorted(first, last);
+
+  BinarySearchTree tree;
+  tree.root = buildBalanced(first, last, count);
+  return tree;
+}
+
+// Count the distinct values of a sorted range, checking the order on the way
+template <typename T, typename BalancePolicy>
+template <typename ForwardIt>
+size_t BinarySearchTree<T, BalancePolicy>::countUniqueSorted(ForwardIt first,
+                                                             ForwardIt last) {
+  if (first == last) {
     return 0;
   }
 
-  size_t leftHeight = heightRecursive(node->left);
-  size_t rightHeight = heightRecursive(node->right);
-
-  return 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+  size_t count = 1;
+  ForwardIt previous = first;
+  for (ForwardIt current = std::next(first); current != last;
+       previous = current++) {
+    if (*current < *previous) {
+      throw std::invalid_argument("fromSorted expects an ascending range");
+    }
+    if (*previous < *current) {
+      ++count;
+    }
+  }
+  return count;
 }
 
-// Find the minimum value in the tree
-template <typename T>
-T BinarySearchTree<T>::findMin() const {
-  if (isEmpty()) {
-    throw std::runtime_error("Operation cannot be performed on empty tree");
+// Build a balanced subtree of the next count distinct values, consuming them
+// in order: left subtree, then the root, then the right subtree. The
+// recursion depth is O(log n). If a copy or a comparison throws, the nodes
+// built so far are freed
+template <typename T, typename BalancePolicy>
+template <typename ForwardIt>
+typename BinarySearchTree<T, BalancePolicy>::Node*
+BinarySearchTree<T, BalancePolicy>::buildBalanced(ForwardIt& next,
+                                                  ForwardIt last,
+                                                  size_t count) {
+  if (count == 0) {
+    return nullptr;
   }
 
-  Node* current = root;
-  while (current->left != nullptr) {
-    current = current->left;
+  Node* left = buildBalanced(next, last, count / 2);
+
+  Node* node;
+  try {
+    node = new Node(*next);
+  } catch (...) {
+    destroyTree(left);
+    throw;
   }
+  node->left = left;
 
-  return current->data;
+  try {
+    ForwardIt current = next;
+    while (++next != last && !(*current < *next)) {
+      // Skip duplicates of this value
+    }
+    node->right = buildBalanced(next, last, count - count / 2 - 1);
+  } catch (...) {
+    destroyTree(node);
+    throw;
+  }
+
+  node->refresh();
+  return node;
 }
 
-// Find the maximum value in the tree
-template <typename T>
-T BinarySearchTree<T>::findMax() const {
-  if (isEmpty()) {
-    throw std::runtime_error("Operation cannot be performed on empty tree");
+// Merge another tree into this one
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::mergeWith(
+    const BinarySearchTree& other) {
+  if (this == &other || other.isEmpty()) {
+    return;
   }
 
-  Node* current = root;
-  while (current->right != nullptr) {
-    current = current->right;
+  std::vector<T> merged;
+  {
+    std::vector<T> mine;
+    std::vector<T> theirs;
+    collectInOrder(root, mine);
+    collectInOrder(other.root, theirs);
+
+    merged.reserve(mine.size() + theirs.size());
+    std::set_union(mine.begin(), mine.end(), theirs.begin(), theirs.end(),
+                   std::back_inserter(merged));
   }
 
-  return current->data;
+  // Built before the old nodes go, so a throwing copy leaves this unchanged
+  auto next = merged.begin();
+  Node* rebuilt = buildBalanced(next, merged.end(), merged.size());
+  clear();
+  root = rebuilt;
 }
 
-// Perform an in-order traversal of the tree
-template <typename T>
-void BinarySearchTree<T>::inOrderTraversal(void (*visit)(const T&)) const {
-  inOrderTraversalRecursive(root, visit);
+// Append the values of a subtree in order. Uses an explicit stack, so a
+// degenerate tree cannot overflow the call stack
+template <typename T, typename BalancePolicy>
+void BinarySearchTree<T, BalancePolicy>::collectInOrder(const Node* node,
+                                                        std::vector<T>& out) {
+  out.reserve(out.size() + countOf(node));
+
+  std::vector<const Node*> path;
+  while (node != nullptr || !path.empty()) {
+    while (node != nullptr) {
+      path.push_back(node);
+      node = node->left;
+    }
+    node = path.back();
+    path.pop_back();
+    out.push_back(node->data);
+    node = node->right;
+  }
 }
 
-// Helper method for in-order traversal
+// Self-balancing tree with O(log n) insert, remove and contains
 template <typename T>
-void BinarySearchTree<T>::inOrderTraversalRecursive(
-    Node* node, void (*visit)(const T&)) const {
-  if (node != nullptr) {
-    inOrderTraversalRecursive(node->left, visit);
-    visit(node->data);
-    inOrderTraversalRecursive(node->right, visit);
-  }
-}
+using AVLTree = BinarySearchTree<T, AVLBalancing>;
 
-#endif
\ No newline at end of file
+#endif
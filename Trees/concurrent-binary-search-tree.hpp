@@ -0,0 +1,227 @@
+#ifndef CONCURRENT_BINARY_SEARCH_TREE_H
+#define CONCURRENT_BINARY_SEARCH_TREE_H
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../Utility/epoch-reclamation.hpp"
+
+// Set that many threads may use at once. contains takes no locks and never
+// waits on a writer. insert and remove lock only the one or two nodes above
+// the leaf they change, so writers on different parts of the tree do not
+// contend.
+//
+// The tree is external (leaf-oriented): values live in the leaves and inner
+// nodes only route, with smaller values to the left. Each update rewrites
+// one child pointer:
+//  - insert replaces a leaf with a small subtree holding it and the new leaf
+//  - remove replaces the leaf's parent with the leaf's sibling
+// A writer locks the nodes whose child pointer it changes, then checks that
+// they are still linked (not marked removed) and still point where its
+// lock-free search found them; if not it searches again. Unlinked nodes are
+// freed through EpochReclamation once no reader can still reach them.
+//
+// Like BinarySearchTree the tree does not rebalance, so sorted insertions
+// degrade it to a chain. T must be default constructible (for the sentinel
+// nodes), copy constructible and comparable with <.
+template <typename T>
+class ConcurrentBinarySearchTree {
+ private:
+  struct Node {
+    T key;
+    // Sentinel keys, ordered above every real key: 0 for a real key, then
+    // 1 < 2
+    unsigned char infinity;
+    bool removed;  // Unlinked; written under this node's lock
+    std::atomic<bool> locked;
+    std::atomic<Node*> left;  // Both null in a leaf
+    std::atomic<Node*> right;
+
+    Node(const T& k, unsigned char inf, Node* l = nullptr, Node* r = nullptr)
+        : key{k}, infinity{inf}, removed{false}, locked{false}, left{l},
+          right{r} {}
+
+    bool isLeaf() const {
+      return left.load(std::memory_order_relaxed) == nullptr;
+    }
+
+    void lock() {
+      while (locked.exchange(true, std::memory_order_acquire)) {
+        while (locked.load(std::memory_order_relaxed)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    void unlock() { locked.store(false, std::memory_order_release); }
+  };
+
+  // Where a search for a value ended
+  struct Position {
+    Node* grandparent;
+    Node* parent;
+    Node* leaf;
+  };
+
+  // The root routes everything to its left, where all real keys live, so
+  // every real leaf has both a parent and a grandparent
+  Node* root;
+  std::atomic<size_t> m_size;
+
+  static bool goesLeft(const T& value, const Node* node) {
+    return node->infinity != 0 || value < node->key;
+  }
+
+  static bool holds(const Node* leaf, const T& value) {
+    return leaf->infinity == 0 && !(value < leaf->key) &&
+           !(leaf->key < value);
+  }
+
+  static std::atomic<Node*>& childLink(Node* node, const T& value) {
+    return goesLeft(value, node) ? node->left : node->right;
+  }
+
+  // Lock-free descent; the caller holds an EpochReclamation::Guard
+  Position search(const T& value) const {
+    Position pos = {nullptr, nullptr, root};
+    while (!pos.leaf->isLeaf()) {
+      pos.grandparent = pos.parent;
+      pos.parent = pos.leaf;
+      pos.leaf = childLink(pos.leaf, value).load(std::memory_order_acquire);
+    }
+    return pos;
+  }
+
+ public:
+  ConcurrentBinarySearchTree() : m_size{0} {
+    root = new Node(T(), 2, new Node(T(), 1), new Node(T(), 2));
+  }
+
+  ConcurrentBinarySearchTree(const ConcurrentBinarySearchTree&) = delete;
+  ConcurrentBinarySearchTree& operator=(const ConcurrentBinarySearchTree&) =
+      delete;
+
+  // Not thread-safe: no other thread may use the tree any more
+  ~ConcurrentBinarySearchTree() {
+    std::vector<Node*> pending(1, root);
+    while (!pending.empty()) {
+      Node* node = pending.back();
+      pending.pop_back();
+      if (!node->isLeaf()) {
+        pending.push_back(node->left.load(std::memory_order_relaxed));
+        pending.push_back(node->right.load(std::memory_order_relaxed));
+      }
+      delete node;
+    }
+  }
+
+  // Returns false if the value was already present
+  bool insert(const T& value) {
+    EpochReclamation::Guard guard;
+    Node* fresh = new Node(value, 0);
+
+    while (true) {
+      Position pos = search(value);
+      if (holds(pos.leaf, value)) {
+        delete fresh;
+        return false;
+      }
+
+      // The leaf and the new value become the two children of a router
+      // keyed by the larger of them
+      Node* leaf = pos.leaf;
+      Node* router = goesLeft(value, leaf)
+                         ? new Node(leaf->key, leaf->infinity, fresh, leaf)
+                         : new Node(value, 0, leaf, fresh);
+
+      Node* parent = pos.parent;
+      std::atomic<Node*>& link = childLink(parent, value);
+      parent->lock();
+      if (!parent->removed && link.load(std::memory_order_relaxed) == leaf) {
+        link.store(router, std::memory_order_release);
+        parent->unlock();
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      parent->unlock();
+      delete router;
+    }
+  }
+
+  // Returns false if the value was not present
+  bool remove(const T& value) {
+    EpochReclamation::Guard guard;
+
+    while (true) {
+      Position pos = search(value);
+      if (!holds(pos.leaf, value)) {
+        return false;
+      }
+
+      Node* grandparent = pos.grandparent;
+      Node* parent = pos.parent;
+      std::atomic<Node*>& upper = childLink(grandparent, value);
+      std::atomic<Node*>& lower = childLink(parent, value);
+
+      // Ancestors are always locked before descendants, and a node never
+      // becomes an ancestor of a node that was above it, so this order
+      // cannot deadlock
+      grandparent->lock();
+      parent->lock();
+      if (!grandparent->removed && !parent->removed &&
+          upper.load(std::memory_order_relaxed) == parent &&
+          lower.load(std::memory_order_relaxed) == pos.leaf) {
+        std::atomic<Node*>& other =
+            &lower == &parent->left ? parent->right : parent->left;
+
+        parent->removed = true;
+        upper.store(other.load(std::memory_order_relaxed),
+                    std::memory_order_release);
+        parent->unlock();
+        grandparent->unlock();
+
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        EpochReclamation::retire(parent);
+        EpochReclamation::retire(pos.leaf);
+        return true;
+      }
+      parent->unlock();
+      grandparent->unlock();
+    }
+  }
+
+  bool contains(const T& value) const {
+    EpochReclamation::Guard guard;
+    return holds(search(value).leaf, value);
+  }
+
+  // Exact when no writer is running
+  size_t size() const { return m_size.load(std::memory_order_relaxed); }
+  bool isEmpty() const { return size() == 0; }
+
+  // Visit the values in ascending order. Runs alongside writers; each value
+  // present for the whole traversal is visited exactly once
+  template <typename Visitor>
+  void inOrderTraversal(Visitor&& visit) const {
+    EpochReclamation::Guard guard;
+
+    std::vector<const Node*> pending(1, root);
+    while (!pending.empty()) {
+      const Node* node = pending.back();
+      pending.pop_back();
+      if (node->isLeaf()) {
+        if (node->infinity == 0) {
+          visit(static_cast<const T&>(node->key));
+        }
+      } else {
+        pending.push_back(node->right.load(std::memory_order_acquire));
+        pending.push_back(node->left.load(std::memory_order_acquire));
+      }
+    }
+  }
+};
+
+#endif
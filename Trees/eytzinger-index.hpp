@@ -0,0 +1,193 @@
+#ifndef EYTZINGER_INDEX_H
+#define EYTZINGER_INDEX_H
+
+#include <stdlib.h>
+
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Immutable search index over a sorted set of keys, stored in Eytzinger
+// (BFS) order: the root at slot 1 and the children of slot k at 2k and
+// 2k + 1. A lookup walks down one array with no pointers to chase. The
+// first levels share a few cache lines that stay hot, and the descent is
+// branch-free, so the CPU never mispredicts the direction. While walking,
+// it prefetches the cache line holding the descendants a few levels down.
+//
+// Built by BinarySearchTree::freeze(), or directly from a sorted range of
+// distinct keys. T must be copy constructible and comparable with <.
+template <typename T>
+class EytzingerIndex {
+ public:
+  EytzingerIndex() : keys{nullptr}, n{0} {}
+
+  // Expects [first, last) sorted ascending without duplicates
+  template <typename ForwardIt>
+  EytzingerIndex(ForwardIt first, ForwardIt last)
+      : keys{nullptr}, n{static_cast<size_t>(std::distance(first, last))} {
+    if (n == 0) {
+      return;
+    }
+
+    // A rank of n marks a slot not built yet, so a throwing copy in fill
+    // destroys only the keys it made
+    ranks.assign(n + 1, n);
+    keys = allocate(n + 1);
+
+    // Slot 0 is never searched; it holds a copy so every slot is constructed
+    try {
+      ::new (static_cast<void*>(keys)) T(*first);
+    } catch (...) {
+      deallocate(keys);
+      throw;
+    }
+
+    try {
+      size_t next = 0;
+      fill(1, first, next);
+    } catch (...) {
+      for (size_t slot = 1; slot <= n; slot++) {
+        if (ranks[slot] < n) {
+          keys[slot].~T();
+        }
+      }
+      keys[0].~T();
+      deallocate(keys);
+      throw;
+    }
+  }
+
+  EytzingerIndex(const EytzingerIndex& other)
+      : keys{nullptr}, ranks{other.ranks}, n{other.n} {
+    if (n == 0) {
+      return;
+    }
+
+    keys = allocate(n + 1);
+    size_t built = 0;
+    try {
+      for (; built <= n; built++) {
+        ::new (static_cast<void*>(keys + built)) T(other.keys[built]);
+      }
+    } catch (...) {
+      while (built > 0) {
+        keys[--built].~T();
+      }
+      deallocate(keys);
+      throw;
+    }
+  }
+
+  EytzingerIndex(EytzingerIndex&& other)
+      : keys{other.keys}, ranks{std::move(other.ranks)}, n{other.n} {
+    other.keys = nullptr;
+    other.n = 0;
+  }
+
+  EytzingerIndex& operator=(EytzingerIndex other) {
+    std::swap(keys, other.keys);
+    std::swap(ranks, other.ranks);
+    std::swap(n, other.n);
+    return *this;
+  }
+
+  ~EytzingerIndex() {
+    if (keys != nullptr) {
+      for (size_t i = 0; i <= n; i++) {
+        keys[i].~T();
+      }
+      deallocate(keys);
+    }
+  }
+
+  size_t size() const { return n; }
+  bool isEmpty() const { return n == 0; }
+
+  bool contains(const T& value) const {
+    size_t slot = search(value);
+    return slot != 0 && !(value < keys[slot]);
+  }
+
+  // The smallest key not less than value, or nullptr if there is none
+  const T* lower_bound(const T& value) const {
+    size_t slot = search(value);
+    return slot != 0 ? keys + slot : nullptr;
+  }
+
+  // Number of keys smaller than value
+  size_t rank(const T& value) const {
+    size_t slot = search(value);
+    return slot != 0 ? ranks[slot] : n;
+  }
+
+ private:
+  static const size_t CACHE_LINE = 64;
+  // The descendants of slot k, log2(KEYS_PER_LINE) levels down, are the
+  // KEYS_PER_LINE slots from k * KEYS_PER_LINE: one aligned cache line
+  static const size_t KEYS_PER_LINE =
+      sizeof(T) < CACHE_LINE ? CACHE_LINE / sizeof(T) : 1;
+
+  T* keys;                    // keys[1..n] in Eytzinger order
+  std::vector<size_t> ranks;  // In-order position of each slot
+  size_t n;
+
+  static T* allocate(size_t count) {
+    return static_cast<T*>(::operator new(count * sizeof(T),
+                                          std::align_val_t(CACHE_LINE)));
+  }
+
+  static void deallocate(T* array) {
+    ::operator delete(array, std::align_val_t(CACHE_LINE));
+  }
+
+  // An in-order walk of the implicit tree receives the keys in sorted order
+  template <typename ForwardIt>
+  void fill(size_t slot, ForwardIt& it, size_t& next) {
+    if (slot > n) {
+      return;
+    }
+
+    fill(2 * slot, it, next);
+    ::new (static_cast<void*>(keys + slot)) T(*it);
+    ranks[slot] = next++;
+    ++it;
+    fill(2 * slot + 1, it, next);
+  }
+
+  // Slot of the smallest key not less than value, or 0 if there is none.
+  // The descent goes left (2k) or right (2k + 1) with no branch; the slot
+  // wanted is where the path last turned left, found by dropping the
+  // trailing right turns and that left turn from k
+  size_t search(const T& value) const {
+    size_t k = 1;
+    while (k <= n) {
+      size_t ahead = k * KEYS_PER_LINE;
+      if (ahead <= n) {
+        prefetch(keys + ahead);
+      }
+      k = 2 * k + (keys[k] < value);
+    }
+    return k >> (trailingOnes(k) + 1);
+  }
+
+  static void prefetch(const T* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+  }
+
+  static unsigned trailingOnes(size_t k) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+    unsigned ones = 0;
+    for (; k & 1; k >>= 1) ++ones;
+    return ones;
+#endif
+  }
+};
+
+#endif
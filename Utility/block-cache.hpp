@@ -0,0 +1,95 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <stdlib.h>
+
+#include <new>
+#include <utility>
+
+// Keeps a few released blocks of one size for reuse, so a segmented
+// container that repeatedly fills and empties the block at one of its ends
+// does not go to malloc each time. Blocks beyond max_cached go back to the
+// system. The cached blocks form an intrusive free list.
+//
+// Not thread-safe; each container owns its cache.
+class BlockCache {
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+ public:
+  static const size_t DEFAULT_MAX_CACHED = 4;
+
+  explicit BlockCache(size_t block_bytes,
+                      size_t max_cached = DEFAULT_MAX_CACHED)
+      : bytes{block_bytes > sizeof(FreeBlock) ? block_bytes
+                                              : sizeof(FreeBlock)},
+        limit{max_cached},
+        free_list{nullptr},
+        count{0} {}
+
+  ~BlockCache() { trim(); }
+
+  BlockCache(const BlockCache&) = delete;
+  BlockCache& operator=(const BlockCache&) = delete;
+
+  BlockCache(BlockCache&& other)
+      : bytes{other.bytes},
+        limit{other.limit},
+        free_list{other.free_list},
+        count{other.count} {
+    other.free_list = nullptr;
+    other.count = 0;
+  }
+
+  void swap(BlockCache& other) {
+    std::swap(bytes, other.bytes);
+    std::swap(limit, other.limit);
+    std::swap(free_list, other.free_list);
+    std::swap(count, other.count);
+  }
+
+  // A block of block_bytes, aligned for any fundamental type
+  void* acquire() {
+    if (free_list == nullptr) {
+      return ::operator new(bytes);
+    }
+
+    FreeBlock* block = free_list;
+    free_list = block->next;
+    --count;
+    return block;
+  }
+
+  void release(void* block) {
+    if (count == limit) {
+      ::operator delete(block);
+      return;
+    }
+
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = free_list;
+    free_list = freed;
+    ++count;
+  }
+
+  size_t cachedBlocks() const { return count; }
+
+  // Give every cached block back to the system
+  void trim() {
+    while (free_list != nullptr) {
+      FreeBlock* next = free_list->next;
+      ::operator delete(free_list);
+      free_list = next;
+    }
+    count = 0;
+  }
+
+ private:
+  size_t bytes;
+  size_t limit;
+  FreeBlock* free_list;
+  size_t count;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef CAPACITY_POLICY_H
+#define CAPACITY_POLICY_H
+
+#include <stdlib.h>
+
+#include <chrono>
+
+// Shrink policies for the array-backed containers (ArrayStack, Queue).
+// After each removal the container asks its policy for a new capacity given
+// the current size and capacity; an answer below the capacity makes it
+// reallocate to that size. Policies are objects so they can keep state
+// between calls.
+//
+// To shrink only on demand, use NeverShrink and call the container's
+// shrink_to_fit() when memory matters more than latency.
+
+// Halve the capacity once the size drops below capacity / Divisor. The gap
+// between this threshold and growth at a full buffer is the hysteresis: with
+// Divisor 4 a container that just shrank must double in size before it grows
+// again, so alternating pushes and pops at a boundary cannot make every
+// operation reallocate. Larger divisors shrink later and less often.
+template <size_t Divisor>
+struct ShrinkBelow {
+  static_assert(Divisor > 2, "a divisor of 2 or less leaves no hysteresis");
+
+  size_t shrinkTo(size_t size, size_t capacity) const {
+    return size > 0 && size < capacity / Divisor ? capacity / 2 : capacity;
+  }
+};
+
+using ShrinkAtQuarter = ShrinkBelow<4>;
+
+// Keep the largest capacity ever reached, so steady-state operations never
+// reallocate
+struct NeverShrink {
+  size_t shrinkTo(size_t, size_t capacity) const { return capacity; }
+};
+
+// Like ShrinkBelow<Divisor>, but only after Removals removals in a row have
+// found the container below the threshold. A workload that dips below it
+// and climbs back within that window never reallocates.
+template <size_t Removals, size_t Divisor = 4>
+class ShrinkWhenQuiet {
+  static_assert(Divisor > 2, "a divisor of 2 or less leaves no hysteresis");
+
+ public:
+  ShrinkWhenQuiet() : below{0} {}
+
+  size_t shrinkTo(size_t size, size_t capacity) {
+    if (size == 0 || size >= capacity / Divisor) {
+      below = 0;
+      return capacity;
+    }
+    if (++below < Removals) {
+      return capacity;
+    }
+
+    below = 0;
+    return capacity / 2;
+  }
+
+ private:
+  size_t below;  // Consecutive removals below the threshold
+};
+
+// Like ShrinkBelow<Divisor>, but only once the container has stayed below
+// the threshold for at least delay. Time is only checked on removals, and
+// only every CLOCK_STRIDE of them, so the clock adds little to a removal.
+template <size_t Divisor = 4, typename Clock = std::chrono::steady_clock>
+class ShrinkAfterDelay {
+  static_assert(Divisor > 2, "a divisor of 2 or less leaves no hysteresis");
+
+ public:
+  static const size_t CLOCK_STRIDE = 64;
+
+  explicit ShrinkAfterDelay(
+      typename Clock::duration delay = std::chrono::milliseconds(100))
+      : delay{delay}, below{0} {}
+
+  size_t shrinkTo(size_t size, size_t capacity) {
+    if (size == 0 || size >= capacity / Divisor) {
+      below = 0;
+      return capacity;
+    }
+    if (below++ == 0) {
+      since = Clock::now();
+      return capacity;
+    }
+    if (below % CLOCK_STRIDE != 0 || Clock::now() - since < delay) {
+      return capacity;
+    }
+
+    below = 0;
+    return capacity / 2;
+  }
+
+ private:
+  typename Clock::duration delay;
+  typename Clock::time_point since;  // First removal below the threshold
+  size_t below;  // Consecutive removals below the threshold
+};
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef EPOCH_RECLAMATION_H
+#define EPOCH_RECLAMATION_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Epoch-based reclamation for lock-free readers of concurrent containers.
+//
+// A reader pins the current global epoch with a Guard while it follows
+// shared pointers. A writer that unlinks a node hands it to retire() rather
+// than deleting it. The node is freed once the global epoch has advanced
+// twice past the epoch it was retired in. By then every thread that could
+// still hold a pointer to it has left its critical section. The epoch
+// advances only when every thread inside a Guard has seen the current one.
+//
+// There is one process-wide domain. Each thread gets a record the first time
+// it enters. When the thread exits, the record is released for another
+// thread to adopt, along with any nodes still waiting to be freed. Records
+// are never deallocated.
+class EpochReclamation {
+  static const uint64_t IDLE = ~uint64_t(0);
+  static const size_t SCAN_INTERVAL = 64;
+
+  struct Retired {
+    void* object;
+    void (*deleter)(void*);
+    uint64_t epoch;
+  };
+
+  struct Record {
+    std::atomic<uint64_t> epoch;  // Epoch pinned by the owner, or IDLE
+    std::atomic<bool> in_use;
+    Record* next;
+
+    // Owner-only state
+    unsigned depth;  // Nesting of Guards
+    size_t retired_since_scan;
+    std::vector<Retired> retired;
+
+    Record() : epoch{IDLE}, in_use{true}, next{nullptr}, depth{0},
+               retired_since_scan{0} {}
+  };
+
+ public:
+  // Pins the current epoch for the lifetime of the guard. Guards nest
+  class Guard {
+   public:
+    Guard() : record{localRecord()} { enter(record); }
+    ~Guard() { leave(record); }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+   private:
+    Record* record;
+  };
+
+  // Free object with deleter once no reader can still reach it. Call after
+  // the object has been unlinked from every shared structure
+  static void retire(void* object, void (*deleter)(void*)) {
+    Record* record = localRecord();
+    record->retired.push_back(
+        {object, deleter, globalEpoch().load(std::memory_order_seq_cst)});
+
+    if (++record->retired_since_scan >= SCAN_INTERVAL) {
+      record->retired_since_scan = 0;
+      tryAdvance();
+      reclaim(record);
+    }
+  }
+
+  template <typename T>
+  static void retire(T* object) {
+    retire(object, [](void* p) { delete static_cast<T*>(p); });
+  }
+
+ private:
+  static std::atomic<uint64_t>& globalEpoch() {
+    static std::atomic<uint64_t> epoch{0};
+    return epoch;
+  }
+
+  // Lock-free list of every record ever created
+  static std::atomic<Record*>& records() {
+    static std::atomic<Record*> head{nullptr};
+    return head;
+  }
+
+  static void enter(Record* record) {
+    if (record->depth++ == 0) {
+      record->epoch.store(globalEpoch().load(std::memory_order_seq_cst),
+                          std::memory_order_seq_cst);
+    }
+  }
+
+  static void leave(Record* record) {
+    if (--record->depth == 0) {
+      record->epoch.store(IDLE, std::memory_order_release);
+    }
+  }
+
+  // Move to the next epoch if no thread is still pinned to an older one
+  static void tryAdvance() {
+    uint64_t current = globalEpoch().load(std::memory_order_seq_cst);
+    for (Record* r = records().load(std::memory_order_acquire); r != nullptr;
+         r = r->next) {
+      uint64_t pinned = r->epoch.load(std::memory_order_seq_cst);
+      if (pinned != IDLE && pinned != current) {
+        return;
+      }
+    }
+    globalEpoch().compare_exchange_strong(current, current + 1,
+                                          std::memory_order_seq_cst);
+  }
+
+  // Free the objects retired at least two epochs ago. A record's list is in
+  // retirement order, so its epochs never decrease and only a prefix can be
+  // ready. Stopping at the first object that is not keeps the scan cheap
+  // while a stalled reader holds the epoch back and the list grows
+  static void reclaim(Record* record) {
+    uint64_t current = globalEpoch().load(std::memory_order_seq_cst);
+    std::vector<Retired>& retired = record->retired;
+
+    size_t ready = 0;
+    while (ready < retired.size() && retired[ready].epoch + 2 <= current) {
+      retired[ready].deleter(retired[ready].object);
+      ++ready;
+    }
+    retired.erase(retired.begin(), retired.begin() + ready);
+  }
+
+  // Reuse a record released by an exited thread, or publish a new one
+  static Record* acquireRecord() {
+    for (Record* r = records().load(std::memory_order_acquire); r != nullptr;
+         r = r->next) {
+      bool expected = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(expected, true,
+                                            std::memory_order_acquire)) {
+        return r;
+      }
+    }
+
+    Record* record = new Record();
+    Record* head = records().load(std::memory_order_relaxed);
+    do {
+      record->next = head;
+    } while (!records().compare_exchange_weak(head, record,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    return record;
+  }
+
+  struct Owner {
+    Record* record;
+
+    Owner() : record{acquireRecord()} {}
+    ~Owner() { record->in_use.store(false, std::memory_order_release); }
+  };
+
+  static Record* localRecord() {
+    thread_local Owner owner;
+    return owner.record;
+  }
+};
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <stdlib.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Fixed-size block pool. Memory is taken from the system in slabs that are
+// carved into blocks with a bump pointer; freed blocks go on an intrusive
+// free list and are handed out again before the slab is touched. Blocks
+// carved from the same slab are adjacent, so nodes allocated together stay
+// close in memory.
+//
+// A NodePool is not thread-safe. Slabs are only returned to the system when
+// the pool is destroyed.
+template <size_t BlockSize, size_t BlockAlign = alignof(std::max_align_t)>
+class NodePool {
+  static_assert(BlockAlign <= alignof(std::max_align_t),
+                "over-aligned blocks are not supported");
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct Slab {
+    Slab* next;
+  };
+
+ public:
+  static const size_t ALIGNMENT =
+      BlockAlign > alignof(FreeBlock) ? BlockAlign : alignof(FreeBlock);
+  static const size_t STRIDE =
+      ((BlockSize > sizeof(FreeBlock) ? BlockSize : sizeof(FreeBlock)) +
+       ALIGNMENT - 1) /
+      ALIGNMENT * ALIGNMENT;
+  static const size_t DEFAULT_SLAB_BYTES = 64 * 1024;
+
+  explicit NodePool(size_t slab_bytes = DEFAULT_SLAB_BYTES)
+      : free_list{nullptr},
+        slabs{nullptr},
+        bump{nullptr},
+        bump_end{nullptr},
+        blocks_per_slab{slab_bytes / STRIDE > 0 ? slab_bytes / STRIDE : 1} {}
+
+  ~NodePool() {
+    while (slabs != nullptr) {
+      Slab* next = slabs->next;
+      ::operator delete(slabs);
+      slabs = next;
+    }
+  }
+
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  void* allocate() {
+    if (free_list != nullptr) {
+      FreeBlock* block = free_list;
+      free_list = block->next;
+      return block;
+    }
+
+    if (bump == bump_end) {
+      addSlab();
+    }
+
+    void* block = bump;
+    bump += STRIDE;
+    return block;
+  }
+
+  void deallocate(void* block) {
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = free_list;
+    free_list = freed;
+  }
+
+  // True when the next allocate() has to go to the system
+  bool exhausted() const { return free_list == nullptr && bump == bump_end; }
+
+  // Take over all slabs and free blocks of other, leaving it empty. Blocks
+  // still in use stay valid and may be freed into either pool
+  void adopt(NodePool& other) {
+    while (other.free_list != nullptr) {
+      FreeBlock* block = other.free_list;
+      other.free_list = block->next;
+      deallocate(block);
+    }
+
+    // The unused tail of other's current slab becomes free blocks too
+    while (other.bump != other.bump_end) {
+      deallocate(other.bump);
+      other.bump += STRIDE;
+    }
+
+    while (other.slabs != nullptr) {
+      Slab* slab = other.slabs;
+      other.slabs = slab->next;
+      slab->next = slabs;
+      slabs = slab;
+    }
+  }
+
+ private:
+  FreeBlock* free_list;
+  Slab* slabs;
+  char* bump;
+  char* bump_end;
+  size_t blocks_per_slab;
+
+  static size_t headerBytes() {
+    return (sizeof(Slab) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+
+  void addSlab() {
+    char* memory = static_cast<char*>(
+        ::operator new(headerBytes() + blocks_per_slab * STRIDE));
+
+    Slab* slab = reinterpret_cast<Slab*>(memory);
+    slab->next = slabs;
+    slabs = slab;
+
+    bump = memory + headerBytes();
+    bump_end = bump + blocks_per_slab * STRIDE;
+  }
+};
+
+// Standard allocator over per-element-type NodePools, meant for node-based
+// containers (List, LL_Queue, LL_Stack). Single-object allocations come from
+// the pool; array allocations fall through to std::allocator.
+//
+// With ThreadLocalCache (the default) every thread owns its pools, so
+// allocation and deallocation are a free-list pop/push with no locking. A
+// block freed on another thread joins that thread's pool. When a thread
+// exits its pools are parked in a shared reserve that other threads draw on,
+// so slabs are recycled rather than freed. Nodes freed after their thread's
+// pool is gone go straight to the reserve.
+//
+// Without ThreadLocalCache all threads share one pool per element type
+// behind a mutex.
+template <typename T, bool ThreadLocalCache = true>
+class PoolAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = PoolAllocator<U, ThreadLocalCache>;
+  };
+
+  PoolAllocator() noexcept {}
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U, ThreadLocalCache>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+
+    Pool* pool = ThreadLocalCache ? localPool() : nullptr;
+    if (pool != nullptr) {
+      if (pool->exhausted()) {
+        std::lock_guard<std::mutex> lock(reserveMutex());
+        pool->adopt(reserve());
+      }
+      return static_cast<T*>(pool->allocate());
+    }
+
+    std::lock_guard<std::mutex> lock(reserveMutex());
+    return static_cast<T*>(reserve().allocate());
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+
+    Pool* pool = ThreadLocalCache ? localPool() : nullptr;
+    if (pool != nullptr) {
+      pool->deallocate(p);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(reserveMutex());
+    reserve().deallocate(p);
+  }
+
+ private:
+  using Pool = NodePool<sizeof(T), alignof(T)>;
+
+  // Never destroyed: containers with static storage may still free nodes
+  // into it during program exit
+  static Pool& reserve() {
+    static Pool* pool = new Pool();
+    return *pool;
+  }
+
+  static std::mutex& reserveMutex() {
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+  }
+
+  // Trivially destructible, so it stays readable while the thread's other
+  // thread_local objects (including static containers' nodes being freed
+  // during exit) are torn down
+  struct LocalState {
+    Pool* pool;
+    bool retired;
+  };
+
+  static LocalState& localState() {
+    thread_local LocalState state = {nullptr, false};
+    return state;
+  }
+
+  struct ThreadCache {
+    Pool pool;
+
+    ThreadCache() { localState().pool = &pool; }
+
+    ~ThreadCache() {
+      localState().pool = nullptr;
+      localState().retired = true;
+      std::lock_guard<std::mutex> lock(reserveMutex());
+      reserve().adopt(pool);
+    }
+  };
+
+  // The calling thread's pool, or nullptr once the thread is exiting and
+  // callers must go through the shared reserve
+  static Pool* localPool() {
+    LocalState& state = localState();
+    if (state.pool == nullptr && !state.retired) {
+      thread_local ThreadCache cache;
+    }
+    return state.pool;
+  }
+};
+
+template <typename T, typename U, bool ThreadLocalCache>
+bool operator==(const PoolAllocator<T, ThreadLocalCache>&,
+                const PoolAllocator<U, ThreadLocalCache>&) {
+  return true;
+}
+
+template <typename T, typename U, bool ThreadLocalCache>
+bool operator!=(const PoolAllocator<T, ThreadLocalCache>&,
+                const PoolAllocator<U, ThreadLocalCache>&) {
+  return false;
+}
+
+#endif
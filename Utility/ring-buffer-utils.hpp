@@ -0,0 +1,23 @@
+#ifndef RING_BUFFER_UTILS_H
+#define RING_BUFFER_UTILS_H
+
+#include <stdlib.h>
+
+// Shared pieces of the ring buffers in Queue/
+
+// Fields written by different threads are kept this far apart so they never
+// share a cache line
+static const size_t CACHE_LINE_SIZE = 64;
+
+// Smallest power of two not below n (1 for n == 0). Ring buffers with a
+// power-of-two capacity map a running position to a slot with a mask
+// instead of a division
+inline size_t next_power_of_two(size_t n) {
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TRIVIALLY_RELOCATABLE_H
+#define TRIVIALLY_RELOCATABLE_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A type is trivially relocatable when moving an object to a new address and
+// destroying the original is equivalent to copying its bytes. Trivially
+// copyable types qualify automatically; user types opt in by specializing:
+//
+//   template <>
+//   struct is_trivially_relocatable<MyType> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+// Smart pointers only hold pointers (and a stateless or trivially copyable
+// deleter), so their bytes can be moved without touching the reference count
+template <typename T, typename Deleter>
+struct is_trivially_relocatable<std::unique_ptr<T, Deleter>>
+    : is_trivially_relocatable<Deleter> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+// Move count elements from one buffer into raw storage and end the lifetime
+// of the originals. Trivially relocatable types are moved with one memcpy
+template <typename T>
+void relocate_elements(T* from, size_t count, T* to) {
+  if (count == 0) return;
+
+  if (is_trivially_relocatable<T>::value) {
+    memcpy(static_cast<void*>(to), static_cast<const void*>(from),
+           count * sizeof(T));
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    ::new (static_cast<void*>(to + i)) T(std::move(from[i]));
+    from[i].~T();
+  }
+}
+
+// Same as above, but the element-wise path goes through the allocator
+template <typename Allocator, typename T>
+void relocate_elements(Allocator& allocator, T* from, size_t count, T* to) {
+  using AllocTraits = std::allocator_traits<Allocator>;
+
+  if (count == 0) return;
+
+  if (is_trivially_relocatable<T>::value) {
+    memcpy(static_cast<void*>(to), static_cast<const void*>(from),
+           count * sizeof(T));
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    AllocTraits::construct(allocator, to + i, std::move(from[i]));
+    AllocTraits::destroy(allocator, from + i);
+  }
+}
+
+#endif